@@ -29,10 +29,13 @@
 
 /*=========================================================  INCLUDE FILES  ==*/
 
+#include "linux/atomic.h"
+#include "linux/seqlock.h"
 #include "rtdm/rtdm_driver.h"
 
 #include "drv/x_spi_ioctl.h"
 #include "drv/x_spi_cfg.h"
+#include "drv/x_spi_lld.h"
 #include "dbg/dbg.h"
 
 /*===============================================================  MACRO's  ==*/
@@ -57,10 +60,31 @@ extern "C" {
 
 /*============================================================  DATA TYPES  ==*/
 
+struct devCtx;
+struct fdCtx;
+
+struct jobCtx {
+    struct xspiJob      desc;                                                   /* Descriptor as submitted by caller                        */
+    struct fdCtx *      owner;                                                  /* Submitting descriptor, NULL if it was closed             */
+    uint32_t            chn;
+    bool_T              reaped;                                                 /* Slot can be reused once older jobs are reaped too        */
+    int32_t             status;
+    uint32_t            length;                                                 /* Bytes of data in tx and rx buffers                       */
+    uint32_t            pack;                                                   /* Word length of packed user data, 0 - not packed          */
+    uint8_t             tx[CFG_JOB_BUFF_SIZE];
+    uint8_t             rx[CFG_JOB_BUFF_SIZE];
+};
+
 struct chnCtx {
     struct unitCtx {
 
     }                   tx, rx;
+    struct chnQueue {
+        struct jobCtx       job[CFG_JOB_QUEUE_DEPTH];
+        uint32_t            head;                                               /* Next job to submit                                       */
+        uint32_t            exec;                                               /* Next job to execute                                      */
+        uint32_t            tail;                                               /* Oldest job not reaped yet                                */
+    }                   queue;
     struct chnCgf {
         enum xspiTransferMode transferMode;
         enum xspiPinLayout  pinLayout;
@@ -68,28 +92,135 @@ struct chnCtx {
         enum xspiCsPolarity csPolarity;
         enum xspiCsState    csState;
         uint32_t            wordLength;
+        uint32_t            clockFreq;                                          /* Requested SPICLK frequency in Hz                         */
+        struct lldChnClk    clk;                                                /* Divider computed for requested frequency                 */
+        uint32_t            jobWeight;                                          /* Jobs executed in one scheduler round                     */
+        uint32_t            xferLevel;                                          /* FIFO level in bytes, 0 - computed per transfer           */
+        enum xspiPacking    packing;
     }                   cfg;
+    struct cyclicCtx {
+        rtdm_timer_t        timer;
+        rtdm_event_t        ready;                                              /* A sample is stored or acquisition is stopped             */
+        struct devCtx *     devCtx;                                             /* Back reference for timer handler                         */
+        struct fdCtx *      owner;                                              /* Descriptor which started acquisition                     */
+        uint32_t            chn;
+        struct xspiCyclic   desc;
+        uint32_t            seq;                                                /* Periods elapsed since start                              */
+        uint32_t            head;                                               /* Next sample to store                                     */
+        uint32_t            tail;                                               /* Next sample to read                                      */
+        bool_T              running;
+        uint8_t             rx[XSPI_CYCLIC_DATA_MAX];
+        struct xspiSample   sample[CFG_CYCLIC_DEPTH];
+    }                   cyclic;
+    struct xspiChnStatus stat;
+    struct fdCtx *      owner;                                                  /* Descriptor which claimed the channel, NULL if shared     */
+    uint32_t            actvCnt;                                                /* Transfers and jobs in progress on the channel            */
     bool_T              online;
 };
 
+struct chnProfile {
+    struct chnCgf       cfg;
+    struct lldChnProfile regs;
+    bool_T              valid;
+};
+
+struct xferCtx {
+    struct rtdm_device * dev;
+    rtdm_irq_t          irq;
+    rtdm_event_t        done;
+    const uint8_t *     tx;
+    uint8_t *           rx;
+    size_t              txLeft;                                                 /* Words still to be written into FIFO                      */
+    size_t              rxLeft;                                                 /* Words still to be read from FIFO                         */
+    uint32_t            wordSize;
+    uint32_t            level;                                                  /* Words serviced per FIFO event                            */
+    uint32_t            chn;
+    int32_t             status;
+    size_t              bytes;
+    nanosecs_abs_t      start;                                                  /* Start time of asynchronous transfer                      */
+    void             (* complete)(struct devCtx *, int32_t);                    /* Completion of asynchronous transfer, NULL if synchronous */
+};
+
+struct ringCtx {
+    atomic_t            ref;                                                    /* Device context and each mapping hold a reference         */
+    struct xspiRingCtrl * ctrl;                                                 /* Start of ring memory                                     */
+    uint8_t *           tx;
+    uint8_t *           rx;
+    size_t              size;
+    uint32_t            frameSize;
+    uint32_t            frames;
+};
+
+struct jobQueue {
+    uint32_t            chn;                                                    /* Channel served by scheduler                              */
+    uint32_t            credit;                                                 /* Jobs left to the channel in this round                   */
+    bool_T              busy;                                                   /* Bus is claimed by a transfer or by job execution         */
+    rtdm_event_t        idle;                                                   /* Bus is released                                          */
+};
+
 struct devCtx {
     rtdm_lock_t         lock;
+    seqcount_t          statSeq;                                                /* Status snapshot, writers hold the device lock            */
     struct globalCfg {
-        enum xspiChn        chn;
         enum xspiFifoChn    fifoChn;/* Channel number with FIFO enabled*/
         enum xspiCsMode     csMode;
         enum xspiMode       mode;
         enum xspiChannelMode channelMode;
         enum xspiInitialDelay   delay;
+        uint32_t            pioThreshold;
     }                   cfg;
     struct chnCtx       chn[DEF_CHN_COUNT];
-    uint32_t            actvCnt;
-    rtdm_sem_t          actvLock;
+    struct chnProfile   profile[CFG_CHN_PROFILES];
+    struct xferCtx      xfer;
+    struct jobQueue     jobs;
+    struct xferBuff {
+#if (0u != CFG_DMA_MODE)
+        uint8_t *           tx;                                                 /* Coherent buffers of CFG_XFER_BUFF_SIZE bytes             */
+        uint8_t *           rx;
+        dma_addr_t          txDma;
+        dma_addr_t          rxDma;
+#else
+        uint8_t             tx[CFG_XFER_BUFF_SIZE];
+        uint8_t             rx[CFG_XFER_BUFF_SIZE];
+#endif
+        uint8_t             stream[CFG_XFER_BUFF_SIZE];                         /* Packed user data of one chunk                            */
+    }                   buff;
+    struct slaveCtx {
+        rtdm_event_t        ready;                                              /* A buffer is filled or streaming is stopped               */
+        struct fdCtx *      owner;                                              /* Descriptor which started streaming                       */
+        uint32_t            chn;
+        uint32_t            size;                                               /* Size of one buffer in bytes                              */
+        uint32_t            wordSize;
+        uint32_t            level;                                              /* Words read per FIFO event                                */
+        uint32_t            fill;                                               /* Bytes received into the buffer being filled              */
+        uint32_t            head;                                               /* Buffer being filled                                      */
+        uint32_t            tail;                                               /* Next buffer handed to reader                             */
+        uint32_t            offset;                                             /* Bytes of tail buffer already read                        */
+        bool_T              running;
+        uint8_t             buff[CFG_SLAVE_BUFFS][CFG_SLAVE_BUFF_SIZE];
+    }                   slave;
+    rtdm_mutex_t        busLock;                                                /* Bus arbiter, waiters are served by priority              */
+    uint32_t            users;                                                  /* Number of open file descriptors                          */
 #if (1u == CFG_DBG_API_VALIDATION)
     portReg_T           signature;
 #endif
 };
 
+/**@brief       Private data of an open file descriptor
+ * @details     All descriptors of one device share its device context.
+ */
+struct fdCtx {
+    struct devCtx *     devCtx;
+    enum xspiChn        chn;                                                    /* Current channel of this descriptor                       */
+    struct ringCtx *    ring;                                                   /* Rings mapped by this descriptor only                     */
+    struct jobCpl {
+        struct jobCtx *     job[DEF_CHN_COUNT * CFG_JOB_QUEUE_DEPTH];           /* Completed jobs of this descriptor in completion order    */
+        uint32_t            head;
+        uint32_t            tail;
+        rtdm_sem_t          done;                                               /* Counts jobs waiting to be reaped                         */
+    }                   cpl;
+};
+
 /*======================================================  GLOBAL VARIABLES  ==*/
 
 /*------------------------------------------------------------------------*//**
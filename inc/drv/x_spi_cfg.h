@@ -38,14 +38,142 @@
 
 /**@brief       DMA mode selection
  * @details     0 - no DMA mode
+ *              1 - EDMA, transfers at or above PIO threshold are moved by
+ *                  EDMA controller between driver buffers and the channel
  */
 #define CFG_DMA_MODE                    0u
 
+/**@brief       NEON bulk paths of word packing
+ * @details     0 - only scalar loops are used
+ *              1 - NEON is used for long 12 and 24 bit streams when kernel is
+ *                  built with CONFIG_KERNEL_MODE_NEON and the caller runs in
+ *                  Linux context
+ */
+#define CFG_PACK_NEON                   1u
+
+/**@brief       TURBO mode of receive only transfers
+ * @details     0 - each word waits for the previous one to be read out
+ *              1 - receive only transfers of at least three words shift the
+ *                  next word while the previous one waits in Rx register
+ */
+#define CFG_XFER_TURBO                  1u
+
 /**@brief       Maximum number of devices
  */
 #define CFG_MAX_DEVICES                 10u
 
+/**@brief       Default size of transfer (in bytes) below which programmed I/O
+ *              engine is always used
+ * @details     This value can be changed at run-time with
+ *              XSPI_IOC_SET_PIO_THRESHOLD request.
+ */
+#define CFG_PIO_THRESHOLD               64u
+
+/**@brief       Maximum number of status register polls while waiting for a
+ *              word in programmed I/O mode
+ */
+#define CFG_PIO_SPIN_LIMIT              100000u
+
+/**@brief       Maximum number of status register polls while waiting for
+ *              module reset to complete
+ */
+#define CFG_RESET_SPIN_LIMIT            10000u
+
+/**@brief       Maximum time in nanoseconds a caller waits for an interrupt
+ *              driven transfer to complete
+ */
+#define CFG_XFER_TIMEOUT_NS             1000000000ull
+
+/**@brief       Worst case interrupt latency in nanoseconds
+ * @details     Used to compute FIFO levels of interrupt driven transfers. FIFO
+ *              keeps enough words to cover this time at channel clock, the
+ *              rest of FIFO space is serviced by one interrupt.
+ */
+#define CFG_XFER_IRQ_LATENCY_NS         20000u
+
+/**@brief       Size of driver transfer buffers in bytes
+ * @details     Larger transfers are split into chunks of this size. Must be
+ *              a multiple of 4.
+ */
+#define CFG_XFER_BUFF_SIZE              1024u
+
+/**@brief       Number of channel profiles which can be saved per device
+ */
+#define CFG_CHN_PROFILES                4u
+
+/**@brief       Number of jobs in submission/completion queue
+ */
+#define CFG_JOB_QUEUE_DEPTH             8u
+
+/**@brief       Maximum size of a job in bytes
+ * @details     Must be a multiple of 4.
+ */
+#define CFG_JOB_BUFF_SIZE               256u
+
+/**@brief       Maximum size of ring mapping in bytes
+ */
+#define CFG_RING_SIZE_MAX               (1024u * 1024u)
+
+/**@brief       Number of samples in cyclic acquisition ring of a channel
+ */
+#define CFG_CYCLIC_DEPTH                256u
+
+/**@brief       Shortest period of cyclic acquisition in nanoseconds
+ */
+#define CFG_CYCLIC_PERIOD_MIN_NS        10000u
+
+/**@brief       Number of receive buffers of slave streaming
+ * @details     One buffer is filled while the others wait for the reader.
+ */
+#define CFG_SLAVE_BUFFS                 4u
+
+/**@brief       Maximum size of one slave streaming buffer in bytes
+ * @details     Must be a multiple of 4.
+ */
+#define CFG_SLAVE_BUFF_SIZE             2048u
+
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+
+#if (1u < CFG_DMA_MODE)
+# error "x_spi: CFG_DMA_MODE must be 0 or 1."
+#endif
+
+#if (1u < CFG_PACK_NEON)
+# error "x_spi: CFG_PACK_NEON must be 0 or 1."
+#endif
+
+#if (1u < CFG_XFER_TURBO)
+# error "x_spi: CFG_XFER_TURBO must be 0 or 1."
+#endif
+
+#if (0u == CFG_CYCLIC_DEPTH)
+# error "x_spi: CFG_CYCLIC_DEPTH must be greater than 0."
+#endif
+
+#if (2u > CFG_SLAVE_BUFFS)
+# error "x_spi: CFG_SLAVE_BUFFS must be at least 2."
+#endif
+
+#if (0u != (CFG_SLAVE_BUFF_SIZE % 4u))
+# error "x_spi: CFG_SLAVE_BUFF_SIZE must be a multiple of 4."
+#endif
+
+#if (0u != CFG_DMA_MODE) && (65535u < CFG_XFER_BUFF_SIZE)
+# error "x_spi: CFG_XFER_BUFF_SIZE exceeds EDMA array count limit."
+#endif
+
+#if (0u != (CFG_XFER_BUFF_SIZE % 4u))
+# error "x_spi: CFG_XFER_BUFF_SIZE must be a multiple of 4."
+#endif
+
+#if (0u != (CFG_JOB_BUFF_SIZE % 4u))
+# error "x_spi: CFG_JOB_BUFF_SIZE must be a multiple of 4."
+#endif
+
+#if (65535u < CFG_JOB_BUFF_SIZE)
+# error "x_spi: CFG_JOB_BUFF_SIZE exceeds word counter limit."
+#endif
+
 /** @endcond *//** @} *//******************************************************
  * END of x_spi_cfg.h
  ******************************************************************************/
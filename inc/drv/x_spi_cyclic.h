@@ -0,0 +1,172 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Interface of cyclic acquisition
+ *********************************************************************//** @{ */
+
+#if !defined(X_SPI_CYCLIC_H_)
+#define X_SPI_CYCLIC_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <rtdm/rtdm_driver.h>
+
+#include "arch/compiler.h"
+#include "drv/x_spi.h"
+
+/*===============================================================  MACRO's  ==*/
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Initialize cyclic acquisition of all channels of a device
+ * @param       devCtx
+ *              Device context
+ */
+void cyclicInit(
+    struct devCtx *     devCtx);
+
+/**@brief       Stop cyclic acquisition and release its timers
+ * @param       devCtx
+ *              Device context
+ */
+void cyclicTerm(
+    struct devCtx *     devCtx);
+
+/**@brief       Start cyclic acquisition on a channel
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which owns the acquisition
+ * @param       chn
+ *              Channel used for acquisition
+ * @param       desc
+ *              Acquisition descriptor
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EBUSY - acquisition is already running on the channel
+ *              -EINVAL - invalid period, length or offset
+ *              !0 - standard Linux error define
+ * @details     Must be called with the bus claimed. Configuration of the
+ *              channel is locked until cyclicStop() is called.
+ */
+int32_t cyclicStart(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    const struct xspiCyclic * desc);
+
+/**@brief       Stop cyclic acquisition on a channel
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which stops the acquisition
+ * @param       chn
+ *              Channel used for acquisition
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EINVAL - acquisition is not running on the channel
+ *              -EACCES - acquisition was started by another descriptor
+ * @details     Must be called with the bus claimed, so no transaction is in
+ *              progress.
+ */
+int32_t cyclicStop(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn);
+
+/**@brief       Is cyclic acquisition running on a channel
+ * @param       devCtx
+ *              Device context
+ * @param       chn
+ *              Channel used for acquisition
+ * @return      TRUE - acquisition is running, FALSE - it is not
+ */
+bool_T cyclicIsRunning(
+    struct devCtx *     devCtx,
+    uint32_t            chn);
+
+/**@brief       Get the oldest stored samples
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which reads the samples
+ * @param       chn
+ *              Channel used for acquisition
+ * @param       timeout
+ *              Wait time in ns, 0 - forever, < 0 - don't wait
+ * @param       samples
+ *              Oldest stored sample
+ * @param       count
+ *              Number of consecutive samples starting at samples, 0 when
+ *              acquisition is stopped
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EWOULDBLOCK - no sample is stored and timeout is negative
+ *              -EACCES - acquisition was started by another descriptor
+ *              !0 - standard Linux error define
+ * @details     Samples stay in the ring until cyclicConsume() is called. Only
+ *              the descriptor which started the acquisition reads samples.
+ */
+int32_t cyclicPeek(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    nanosecs_rel_t      timeout,
+    const struct xspiSample ** samples,
+    size_t *            count);
+
+/**@brief       Release samples returned by cyclicPeek()
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which read the samples
+ * @param       chn
+ *              Channel used for acquisition
+ * @param       count
+ *              Number of samples to release, ignored when acquisition is no
+ *              longer owned by fdCtx
+ */
+void cyclicConsume(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    size_t              count);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_cyclic.h
+ ******************************************************************************/
+#endif /* X_SPI_CYCLIC_H_ */
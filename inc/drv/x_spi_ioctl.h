@@ -50,7 +50,7 @@ enum xspiChn {
 };
 
 /**@brief       Set the current channel being configured
- * @details     0 - 3 channel
+ * @details     0 - 3 channel. Current channel is kept per file descriptor.
  */
 #define XSPI_IOC_SET_CURRENT_CHN        _IOW(XSPI_IOC_MAGIC, 1, int)
 
@@ -160,6 +160,23 @@ enum xspiInitialDelay {
  */
 #define XSPI_IOC_GET_INITIAL_DELAY      _IOR(XSPI_IOC_MAGIC, 106, int)
 
+/* --------------------------------------------------------------------------
+ * Programmed I/O threshold
+ * -------------------------------------------------------------------------- */
+
+/**@brief       Set transfer size in bytes below which programmed I/O is used
+ * @details     Short transfers are always executed by polling channel status
+ *              which gives the lowest latency. On the FIFO channel polling
+ *              keeps the FIFO filled and lets the word counter end the
+ *              transfer, so longer transfers run at close to wire rate as
+ *              well.
+ */
+#define XSPI_IOC_SET_PIO_THRESHOLD      _IOW(XSPI_IOC_MAGIC, 16, int)
+
+/**@brief       Get programmed I/O threshold
+ */
+#define XSPI_IOC_GET_PIO_THRESHOLD      _IOR(XSPI_IOC_MAGIC, 116, int)
+
 /**@} *//*----------------------------------------------------------------*//**
  * @name        Per channel settings
  * @{ *//*--------------------------------------------------------------------*/
@@ -176,7 +193,8 @@ enum xspiTransferMode {
 
 /**@brief       Transmit/receive modes
  * @details     0 - Transmit and receive mode
- *              1 - Receive mode only
+ *              1 - Receive mode only, transfers of three or more words
+ *                  stream in TURBO mode without a gap between words
  *              2 - Transmit mode only
  */
 #define XSPI_IOC_SET_TRANSFER_MODE      _IOW(XSPI_IOC_MAGIC, 7, int)
@@ -282,10 +300,14 @@ enum xspiCsState {
  * -------------------------------------------------------------------------- */
 
 /**@brief       Define SPICLK clock frequency
+ * @details     Argument is frequency in Hz. The highest frequency which does
+ *              not exceed the requested one is selected.
  */
 #define XSPI_IOC_SET_CLOCK_FREQ         _IOW(XSPI_IOC_MAGIC, 13, int)
 
 /**@brief       Get SPICLK clock frequency
+ * @details     Returns the achieved frequency in Hz, which may be lower than
+ *              the one requested by XSPI_IOC_SET_CLOCK_FREQ.
  */
 #define XSPI_IOC_GET_CLOCK_FREQ         _IOR(XSPI_IOC_MAGIC, 113, int)
 
@@ -327,23 +349,399 @@ enum xspiClockPolarity {
  */
 #define XSPI_IOC_GET_CLOCK_POLARITY     _IOR(XSPI_IOC_MAGIC, 115, int)
 
+/* --------------------------------------------------------------------------
+ * Channel profiles
+ * -------------------------------------------------------------------------- */
+
+/**@brief       Save configuration of current channel into a profile
+ * @details     Argument is profile number, from 0 to CFG_CHN_PROFILES - 1.
+ *              Transfer mode, pin layout, word length, CS delay, CS polarity
+ *              and clock settings are saved.
+ */
+#define XSPI_IOC_SAVE_PROFILE           _IOW(XSPI_IOC_MAGIC, 17, int)
+
+/**@brief       Load a saved profile into current channel
+ * @details     Argument is profile number. The profile may be loaded into any
+ *              channel and is applied with a single register write. CS state
+ *              of the channel is not changed.
+ */
+#define XSPI_IOC_LOAD_PROFILE           _IOW(XSPI_IOC_MAGIC, 18, int)
+
+/* --------------------------------------------------------------------------
+ * Job scheduling
+ * -------------------------------------------------------------------------- */
+
+/**@brief       Define job weight of the channel
+ * @details     Number of queued jobs the channel executes before the next
+ *              channel is served, from 1 to 255. Default is 1.
+ */
+#define XSPI_IOC_SET_JOB_WEIGHT         _IOW(XSPI_IOC_MAGIC, 19, int)
+
+/**@brief       Get job weight of the channel
+ */
+#define XSPI_IOC_GET_JOB_WEIGHT         _IOR(XSPI_IOC_MAGIC, 119, int)
+
+/* --------------------------------------------------------------------------
+ * Channel ownership
+ * -------------------------------------------------------------------------- */
+
+/**@brief       Claim a channel for this file descriptor
+ * @details     0 - 3 channel. Only the owner may configure a claimed channel,
+ *              transfer on it or submit jobs to it. Unclaimed channels are
+ *              shared by all file descriptors. Returns -EBUSY when the channel
+ *              is owned by another file descriptor. Channels are released when
+ *              the file descriptor is closed.
+ */
+#define XSPI_IOC_CLAIM_CHN              _IOW(XSPI_IOC_MAGIC, 20, int)
+
+/**@brief       Release a channel claimed by this file descriptor
+ */
+#define XSPI_IOC_RELEASE_CHN            _IOW(XSPI_IOC_MAGIC, 21, int)
+
+/* --------------------------------------------------------------------------
+ * FIFO levels
+ * -------------------------------------------------------------------------- */
+
+/**@brief       Define FIFO level of the channel in bytes
+ * @details     Number of bytes moved per FIFO interrupt, polled FIFO load or
+ *              DMA request, from 1 to 32. Rounded down to a multiple of word size. DMA uses the
+ *              largest power-of-two burst which fits in the level and divides
+ *              the transfer. Default 0 computes the level for each transfer
+ *              from word length, channel clock and transfer size.
+ */
+#define XSPI_IOC_SET_XFER_LEVEL         _IOW(XSPI_IOC_MAGIC, 22, int)
+
+/**@brief       Get FIFO level of the channel, 0 - computed per transfer
+ */
+#define XSPI_IOC_GET_XFER_LEVEL         _IOR(XSPI_IOC_MAGIC, 122, int)
+
+/* --------------------------------------------------------------------------
+ * Data packing
+ * -------------------------------------------------------------------------- */
+
+enum xspiPacking {
+    XSPI_PACKING_NONE           = 0,
+    XSPI_PACKING_MSB_FIRST      = 1
+};
+
+/**@brief       Define layout of data in user buffers
+ * @details     0 - Each word takes 1, 2 or 4 bytes in native byte order
+ *              1 - Words are packed back to back, most significant bit first,
+ *                  for example two 12-bit words take 3 bytes. Buffer length
+ *                  must hold a whole number of words.
+ *              Applies to reads, writes, transfers, messages and jobs. Ring
+ *              mappings always use the unpacked layout.
+ */
+#define XSPI_IOC_SET_PACKING            _IOW(XSPI_IOC_MAGIC, 23, int)
+
+/**@brief       Get layout of data in user buffers
+ */
+#define XSPI_IOC_GET_PACKING            _IOR(XSPI_IOC_MAGIC, 123, int)
+
 
 /**@} *//*----------------------------------------------------------------*//**
  * @name        SPI Status
  * @brief       All IOC data/control is per channel
+ * @details     Status and all XSPI_IOC_GET_* requests return without waiting
+ *              for transfers in progress.
  * @{ *//*--------------------------------------------------------------------*/
 
 /**@brief       Get the device status
+ * @details     Argument is a pointer to struct xspiStatus.
  */
-#define XSPI_IOC_GET_STATUS             _IOR(XSPI_IOC_MAGIC, 200, int)
+#define XSPI_IOC_GET_STATUS             _IOR(XSPI_IOC_MAGIC, 200, struct xspiStatus)
 
 /**@brief       Get the channel status
+ * @details     Argument is a pointer to struct xspiChnStatus. Status of the
+ *              current channel is returned.
  */
-#define XSPI_IOC_GET_CHN_STATUS         _IOR(XSPI_IOC_MAGIC, 201, int)
+#define XSPI_IOC_GET_CHN_STATUS         _IOR(XSPI_IOC_MAGIC, 201, struct xspiChnStatus)
+
+/**@} *//*----------------------------------------------------------------*//**
+ * @name        SPI Transfers
+ * @brief       Transfers are executed on the current channel
+ * @details     A device may be opened by several clients. The bus is granted
+ *              to the waiting client with the highest priority. Transfers and
+ *              reads/writes release the bus between CFG_XFER_BUFF_SIZE chunks,
+ *              messages hold it until the last segment is done.
+ *              While a transfer or job runs on a channel, settings of that
+ *              channel and device-global settings return -EAGAIN. Settings of
+ *              other channels are accepted.
+ * @{ *//*--------------------------------------------------------------------*/
+
+/**@brief       Execute one full-duplex transfer
+ * @details     Argument is a pointer to struct xspiTransfer. Words from tx
+ *              buffer are sent while received words are stored into rx
+ *              buffer. Channel must be in XSPI_TRANSFER_MODE_TX_AND_RX mode
+ *              when both buffers are given.
+ */
+#define XSPI_IOC_TRANSFER               _IOW(XSPI_IOC_MAGIC, 300, struct xspiTransfer)
+
+/**@brief       Execute a message made of several segments
+ * @details     Argument is a pointer to struct xspiMessage. Segments are
+ *              executed in order until all are done or one of them fails. Word
+ *              length given in a segment applies only to that segment, channel
+ *              settings are restored when the message ends. In single channel
+ *              mode CS is asserted at the beginning of a segment and released
+ *              at its end unless csKeep is set.
+ */
+#define XSPI_IOC_MESSAGE                _IOW(XSPI_IOC_MAGIC, 301, struct xspiMessage)
+
+/**@brief       Map transfer rings into the caller address space
+ * @details     Argument is a pointer to struct xspiRingMap. Rings belong to
+ *              the descriptor, they are allocated on its first request and
+ *              later requests must ask for the same geometry. Mapping starts
+ *              with struct xspiRingCtrl. Must be called from non real-time
+ *              context.
+ */
+#define XSPI_IOC_RING_MAP               _IOWR(XSPI_IOC_MAGIC, 302, struct xspiRingMap)
+
+/**@brief       Execute frames queued in Tx ring
+ * @details     Each queued frame is transferred on the current channel and
+ *              received data is stored into the next free Rx ring slot.
+ *              Processing stops when Tx ring is empty, Rx ring is full or
+ *              one ring of frames is executed. Returns the number of executed
+ *              frames, -EINVAL when ring indexes are out of range.
+ */
+#define XSPI_IOC_RING_KICK              _IO(XSPI_IOC_MAGIC, 303)
+
+/**@brief       Post a job to submission queue
+ * @details     Argument is a pointer to struct xspiJob. Tx data is copied at
+ *              submission and the job executes on the channel given in the
+ *              descriptor. Each channel has its own queue. The request returns
+ *              without waiting for the job. Returns -EAGAIN when the queue of
+ *              the channel is full.
+ *              Queues are served in round-robin order, a channel executes up
+ *              to its job weight jobs in one round.
+ *              Jobs are executed back-to-back from interrupt context, so only
+ *              the FIFO channel accepts them, other channels return
+ *              -EOPNOTSUPP. A job which can't be started when its turn comes
+ *              completes with the error.
+ */
+#define XSPI_IOC_JOB_SUBMIT             _IOW(XSPI_IOC_MAGIC, 304, struct xspiJob)
+
+/**@brief       Reap a job from completion queue
+ * @details     Argument is a pointer to struct xspiJobResult. A descriptor
+ *              reaps only the jobs it submitted, in completion order. Jobs of
+ *              one channel complete in submission order. Rx data is copied to
+ *              the buffer given at submission. Jobs not executed when their
+ *              descriptor is closed are cancelled.
+ */
+#define XSPI_IOC_JOB_REAP               _IOWR(XSPI_IOC_MAGIC, 305, struct xspiJobResult)
+
+/**@brief       Start cyclic acquisition on the current channel
+ * @details     Argument is a pointer to struct xspiCyclic. The transaction is
+ *              executed by programmed I/O once per period from a driver timer,
+ *              its received data is stored as struct xspiSample into a ring of
+ *              CFG_CYCLIC_DEPTH samples. While acquisition runs, read() on the
+ *              channel returns whole samples instead of starting a transfer,
+ *              it waits only for the first one. Only the descriptor which
+ *              started the acquisition reads samples, read() on other
+ *              descriptors returns -EACCES. A period is skipped when the
+ *              bus is in use or the ring is full, see struct xspiChnStatus.
+ *              Channel settings return -EAGAIN until acquisition is stopped.
+ *              Acquisition is stopped when its descriptor is closed.
+ */
+#define XSPI_IOC_CYCLIC_START           _IOW(XSPI_IOC_MAGIC, 306, struct xspiCyclic)
+
+/**@brief       Stop cyclic acquisition on the current channel
+ * @details     Samples not read yet are discarded and waiting readers return
+ *              zero. Returns -EACCES when acquisition was started by another
+ *              descriptor.
+ */
+#define XSPI_IOC_CYCLIC_STOP            _IO(XSPI_IOC_MAGIC, 307)
+
+/**@brief       Execute one full-duplex transfer and return its timestamps
+ * @details     Argument is a pointer to struct xspiTransferTs. Transfer is
+ *              executed as by XSPI_IOC_TRANSFER. Timestamps are taken by the
+ *              driver right before the first word is sent and right after the
+ *              last word is received, the same times are recorded in channel
+ *              status.
+ */
+#define XSPI_IOC_TRANSFER_TS            _IOWR(XSPI_IOC_MAGIC, 308, struct xspiTransferTs)
+
+/**@brief       Start slave streaming on the current channel
+ * @details     Argument is the size of one receive buffer in bytes, a multiple
+ *              of word size up to CFG_SLAVE_BUFF_SIZE. Module must be in
+ *              XSPI_MODE_SLAVE, the channel must own the FIFO and be in
+ *              XSPI_TRANSFER_MODE_RX_ONLY mode. The FIFO is serviced from
+ *              interrupt into CFG_SLAVE_BUFFS buffers, when one buffer is full
+ *              the next one is filled without a gap. While streaming runs,
+ *              read() on the channel returns data of filled buffers, it waits
+ *              only when none is filled. Only the descriptor which started
+ *              streaming reads data, read() on other descriptors returns
+ *              -EACCES. When the reader holds all other buffers the full one is
+ *              overwritten. Receive FIFO level is half of the FIFO space, or the
+ *              one set by XSPI_IOC_SET_XFER_LEVEL, channel clock frequency is
+ *              not used. Transfers return -EBUSY until streaming is stopped.
+ *              Streaming is stopped when its descriptor is closed.
+ */
+#define XSPI_IOC_SLAVE_START            _IOW(XSPI_IOC_MAGIC, 309, int)
+
+/**@brief       Stop slave streaming on the current channel
+ * @details     Data not read yet and words left in FIFO are discarded, waiting
+ *              readers return zero. Returns -EACCES when streaming was started
+ *              by another descriptor.
+ */
+#define XSPI_IOC_SLAVE_STOP             _IO(XSPI_IOC_MAGIC, 310)
 
 /**@} *//*--------------------------------------------------------------------*/
 
 /*============================================================  DATA TYPES  ==*/
+
+/**@brief       Maximum length of cyclic transaction in bytes
+ */
+#define XSPI_CYCLIC_DATA_MAX            16u
+
+/**@brief       Transfer engines
+ */
+enum xspiEngine {
+    XSPI_ENGINE_PIO             = 0,                                            /**< Programmed I/O, polled                                 */
+    XSPI_ENGINE_IRQ             = 1,                                            /**< FIFO serviced from interrupt                           */
+    XSPI_ENGINE_DMA             = 2,                                            /**< Buffers moved by DMA controller                        */
+    XSPI_ENGINE_COUNT
+};
+
+/**@brief       Transfer statistics of one engine
+ * @details     All times are in nanoseconds and measure the time spent on the
+ *              bus, user buffer copying is not included.
+ */
+struct xspiEngineStatus {
+    uint32_t            xfers;                                                  /**< Number of completed transfers                          */
+    uint32_t            errors;                                                 /**< Number of failed transfers                             */
+    uint64_t            bytes;                                                  /**< Number of transferred bytes                            */
+    uint64_t            time;                                                   /**< Total transfer time                                    */
+    uint32_t            timeLast;                                               /**< Duration of the last transfer                          */
+    uint32_t            timeMin;                                                /**< Duration of the shortest transfer                      */
+    uint32_t            timeMax;                                                /**< Duration of the longest transfer                       */
+};
+
+/**@brief       Device status
+ * @details     All times are in nanoseconds.
+ */
+struct xspiStatus {
+    uint32_t            resets;                                                 /**< Number of completed module resets                      */
+    uint32_t            resetErrors;                                            /**< Number of resets which did not complete in time        */
+    uint32_t            resetTimeLast;                                          /**< Duration of the last reset                             */
+    uint32_t            resetTimeMin;                                           /**< Duration of the shortest reset                         */
+    uint32_t            resetTimeMax;                                           /**< Duration of the longest reset                          */
+};
+
+/**@brief       Channel status
+ * @details     Timestamps are monotonic time in nanoseconds as returned by
+ *              rtdm_clock_read_monotonic(). For a read, write or transfer
+ *              split into chunks they cover all chunks.
+ */
+struct xspiChnStatus {
+    struct xspiEngineStatus engine[XSPI_ENGINE_COUNT];
+    uint64_t            timeStart;                                              /**< Start of the last successful transfer                  */
+    uint64_t            timeEnd;                                                /**< End of the last successful transfer                    */
+    uint32_t            cyclicSamples;                                          /**< Number of stored cyclic samples                        */
+    uint32_t            cyclicBusy;                                             /**< Periods skipped because the bus was in use             */
+    uint32_t            cyclicOverruns;                                         /**< Periods skipped because sample ring was full           */
+    uint32_t            slaveBuffs;                                             /**< Number of filled slave streaming buffers               */
+    uint32_t            slaveOverruns;                                          /**< Buffers refilled because reader held all others        */
+    uint32_t            slaveOverflows;                                         /**< Number of Rx FIFO overflows                            */
+};
+
+/**@brief       Full-duplex transfer descriptor
+ */
+struct xspiTransfer {
+    const void *        tx;                                                     /**< Words to send, if NULL zeros are sent                  */
+    void *              rx;                                                     /**< Received words, if NULL they are discarded             */
+    uint32_t            length;                                                 /**< Length of transfer in bytes                            */
+};
+
+/**@brief       Timestamped full-duplex transfer descriptor
+ */
+struct xspiTransferTs {
+    struct xspiTransfer transfer;
+    uint64_t            timeStart;                                              /**< Returned monotonic time of transfer start in ns        */
+    uint64_t            timeEnd;                                                /**< Returned monotonic time of transfer end in ns          */
+};
+
+/**@brief       One segment of a message
+ */
+struct xspiSegment {
+    const void *        tx;                                                     /**< Words to send, if NULL zeros are sent                  */
+    void *              rx;                                                     /**< Received words, if NULL they are discarded             */
+    uint32_t            length;                                                 /**< Length of segment in bytes                             */
+    uint32_t            wordLength;                                             /**< Word length in bits, 0 - use channel setting           */
+    uint32_t            clockFreq;                                              /**< SPICLK frequency in Hz, 0 - use channel setting        */
+    uint32_t            csKeep;                                                 /**< Keep CS asserted after this segment                    */
+};
+
+/**@brief       Job descriptor
+ */
+struct xspiJob {
+    const void *        tx;                                                     /**< Words to send, if NULL zeros are sent                  */
+    void *              rx;                                                     /**< Received words, if NULL they are discarded             */
+    uint32_t            length;                                                 /**< Length of job in bytes, at most CFG_JOB_BUFF_SIZE      */
+    uint32_t            tag;                                                    /**< Caller value returned with result                      */
+    int32_t             chn;                                                    /**< Channel of the job, < 0 - current channel              */
+};
+
+/**@brief       Job result
+ */
+struct xspiJobResult {
+    int64_t             timeout;                                                /**< Wait time in ns, 0 - forever, < 0 - don't wait         */
+    uint32_t            tag;                                                    /**< Tag of completed job                                   */
+    int32_t             status;                                                 /**< 0 or standard Linux error define                       */
+};
+
+/**@brief       Ring mapping request
+ */
+struct xspiRingMap {
+    uint32_t            frameSize;                                              /**< Size of one frame in bytes                             */
+    uint32_t            frames;                                                 /**< Number of frames in each ring                          */
+    uint32_t            size;                                                   /**< Returned size of mapping in bytes                      */
+    void *              addr;                                                   /**< Returned address of mapping                            */
+};
+
+/**@brief       Ring control block at the start of ring mapping
+ * @details     Indexes are free running, a frame slot is index modulo number
+ *              of frames. Caller produces Tx frames by advancing txHead and
+ *              consumes Rx frames by advancing rxTail, the driver advances the
+ *              other two.
+ */
+struct xspiRingCtrl {
+    uint32_t            frameSize;                                              /**< Size of one frame in bytes                             */
+    uint32_t            frames;                                                 /**< Number of frames in each ring                          */
+    uint32_t            txOffset;                                               /**< Offset of Tx ring from the start of mapping            */
+    uint32_t            rxOffset;                                               /**< Offset of Rx ring from the start of mapping            */
+    volatile uint32_t   txHead;                                                 /**< Written by caller                                      */
+    volatile uint32_t   txTail;                                                 /**< Written by driver                                      */
+    volatile uint32_t   rxHead;                                                 /**< Written by driver                                      */
+    volatile uint32_t   rxTail;                                                 /**< Written by caller                                      */
+};
+
+/**@brief       Cyclic acquisition descriptor
+ * @details     Tx data and samples hold words in driver word slots, packing
+ *              does not apply.
+ */
+struct xspiCyclic {
+    uint64_t            period;                                                 /**< Period in ns                                           */
+    uint32_t            length;                                                 /**< Length of transaction in bytes                         */
+    uint32_t            offset;                                                 /**< Received bytes before offset are not stored            */
+    uint8_t             tx[XSPI_CYCLIC_DATA_MAX];                               /**< Words sent in each transaction                         */
+};
+
+/**@brief       Sample of cyclic acquisition
+ */
+struct xspiSample {
+    uint64_t            time;                                                   /**< Monotonic time of transaction start in ns              */
+    uint32_t            seq;                                                    /**< Period number, gaps are skipped periods                */
+    int32_t             status;                                                 /**< 0 or standard Linux error define                       */
+    uint8_t             rx[XSPI_CYCLIC_DATA_MAX];                               /**< Received bytes from offset to the end of transaction   */
+};
+
+/**@brief       Message descriptor
+ */
+struct xspiMessage {
+    const struct xspiSegment * segments;                                        /**< Array of segments                                      */
+    uint32_t            count;                                                  /**< Number of segments                                     */
+};
+
 /*======================================================  GLOBAL VARIABLES  ==*/
 /*===================================================  FUNCTION PROTOTYPES  ==*/
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
@@ -0,0 +1,180 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Interface of job queues
+ *********************************************************************//** @{ */
+
+#if !defined(X_SPI_JOB_H_)
+#define X_SPI_JOB_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <rtdm/rtdm_driver.h>
+
+#include "arch/compiler.h"
+#include "drv/x_spi.h"
+
+/*===============================================================  MACRO's  ==*/
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Initialize job queue of a device context
+ * @param       devCtx
+ *              Device context
+ */
+void jobInit(
+    struct devCtx *     devCtx);
+
+/**@brief       Terminate job queue of a device context
+ * @param       devCtx
+ *              Device context
+ * @details     Transfer engines must be terminated before this call.
+ */
+void jobTerm(
+    struct devCtx *     devCtx);
+
+/**@brief       Initialize completion queue of a file descriptor
+ * @param       fdCtx
+ *              File descriptor context
+ */
+void jobFdInit(
+    struct fdCtx *      fdCtx);
+
+/**@brief       Terminate completion queue of a file descriptor
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor context
+ * @details     Queued jobs of the descriptor are cancelled and its completed
+ *              jobs are discarded.
+ */
+void jobFdTerm(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx);
+
+/**@brief       Claim the bus for a synchronous transfer or configuration
+ * @param       devCtx
+ *              Device context
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              !0 - standard Linux error define
+ * @details     Waits until all submitted jobs are executed.
+ */
+int32_t jobBusGet(
+    struct devCtx *     devCtx);
+
+/**@brief       Release the bus claimed by jobBusGet()
+ * @param       devCtx
+ *              Device context
+ * @details     Jobs submitted in the meantime are started.
+ */
+void jobBusPut(
+    struct devCtx *     devCtx);
+
+/**@brief       Claim the bus without waiting
+ * @param       devCtx
+ *              Device context
+ * @return      TRUE - bus is claimed, FALSE - bus is in use
+ * @details     May be called from interrupt or timer context.
+ */
+bool_T jobBusTryGet(
+    struct devCtx *     devCtx);
+
+/**@brief       Release the bus claimed by jobBusTryGet()
+ * @param       devCtx
+ *              Device context
+ * @details     Jobs submitted in the meantime are started, may be called
+ *              from interrupt or timer context.
+ */
+void jobBusPutIrq(
+    struct devCtx *     devCtx);
+
+/**@brief       Post a job to submission queue
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              Submitting file descriptor, completion is posted to it
+ * @param       chn
+ *              Channel used for the job
+ * @param       desc
+ *              Job descriptor
+ * @param       tx
+ *              Kernel copy of Tx data, NULL if zeros are sent
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EAGAIN - queue of the channel is full
+ *              -EINVAL - invalid length or channel
+ *              -EOPNOTSUPP - channel does not own the FIFO
+ *              !0 - standard Linux error define
+ */
+int32_t jobSubmit(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    const struct xspiJob * desc,
+    const void *        tx);
+
+/**@brief       Reap the first completed job of a file descriptor
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which submitted the job
+ * @param       timeout
+ *              Wait time in ns, 0 - forever, < 0 - don't wait
+ * @param       desc
+ *              Descriptor of the completed job
+ * @param       status
+ *              Status of the completed job
+ * @param       rx
+ *              Storage of CFG_JOB_BUFF_SIZE bytes for received data
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EWOULDBLOCK - no job is completed and timeout is negative
+ *              !0 - standard Linux error define
+ */
+int32_t jobReap(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    nanosecs_rel_t      timeout,
+    struct xspiJob *    desc,
+    int32_t *           status,
+    void *              rx);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_job.h
+ ******************************************************************************/
+#endif /* X_SPI_JOB_H_ */
@@ -30,17 +30,63 @@
 
 /*=========================================================  INCLUDE FILES  ==*/
 
+#include <linux/types.h>
 #include <rtdm/rtdm_driver.h>
 
 #include "arch/compiler.h"
 
 /*===============================================================  MACRO's  ==*/
+
+/**@brief       Size of module FIFO buffer in bytes
+ * @details     When FIFO is used in both directions each direction gets one
+ *              half of the buffer.
+ */
+#define LLD_FIFO_DEPTH                  64u
+
+/**@brief       Maximum word count which can be programmed into XFERLEVEL
+ */
+#define LLD_WCNT_MAX                    0xffffu
+
+/*------------------------------------------------------------------------*//**
+ * @name        Interrupt events
+ * @{ *//*--------------------------------------------------------------------*/
+
+#define LLD_IRQ_TX_EMPTY(chn)           (0x01u << ((chn) * 4u))
+#define LLD_IRQ_TX_UNDERFLOW(chn)       (0x02u << ((chn) * 4u))
+#define LLD_IRQ_RX_FULL(chn)            (0x04u << ((chn) * 4u))
+#define LLD_IRQ_RX_OVERFLOW             (0x08u)
+#define LLD_IRQ_EOW                     (0x01u << 17)
+
+/**@} *//*----------------------------------------------------------------*/
 /*------------------------------------------------------  C++ extern begin  --*/
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /*============================================================  DATA TYPES  ==*/
+
+struct xspiStatus;
+
+/**@brief       Precomputed channel clock divider
+ * @details     Filled by lldChnClkSolve() and written to the channel by
+ *              lldChnClkSet() without further computation.
+ */
+struct lldChnClk {
+    uint32_t            conf;                                                   /* CLKG and CLKD bits of MCSPI_CH(i)CONF                    */
+    uint32_t            ctrl;                                                   /* EXTCLK bits of MCSPI_CH(i)CTRL                           */
+    uint32_t            freq;                                                   /* Achieved SPICLK frequency in Hz                          */
+};
+
+/**@brief       Compiled channel profile
+ * @details     Holds complete MCSPI_CH(i)CONF and MCSPI_CH(i)CTRL settings
+ *              of a channel, without the bits which are managed during a
+ *              transfer (FIFO, DMA, CS force and channel enable bits).
+ */
+struct lldChnProfile {
+    uint32_t            conf;
+    uint32_t            ctrl;
+};
+
 /*======================================================  GLOBAL VARIABLES  ==*/
 /*===================================================  FUNCTION PROTOTYPES  ==*/
 
@@ -69,13 +115,53 @@ void lldDevTerm(
 volatile uint8_t * lldRemapGet(
     struct rtdm_device * dev);
 
+/**@brief       Begin a batch of register changes
+ * @param       dev
+ *              RT device descriptor
+ * @details     Until lldBatchCommit() is called configuration registers are
+ *              changed only in shadow memory. Batches may be nested, the
+ *              registers are written when the outermost batch is committed.
+ * @note        Must not be used around functions which wait for the hardware
+ *              (transfers, FIFO access, EOT wait). Once the device is shared
+ *              the device lock must be held from begin to commit, otherwise
+ *              register changes of other callers are deferred into the batch.
+ */
+void lldBatchBegin(
+    struct rtdm_device * dev);
+
+/**@brief       Commit a batch of register changes
+ * @param       dev
+ *              RT device descriptor
+ * @details     Only changed registers are written, in the following order:
+ *              channel disables, MODULCTRL, channel CONF registers,
+ *              XFERLEVEL, IRQENABLE and at last remaining channel CTRL
+ *              registers.
+ */
+void lldBatchCommit(
+    struct rtdm_device * dev);
+
 /**@brief       Reset device module
  * @param       dev
  *              RT device descriptor
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -ETIMEDOUT - reset did not complete within
+ *                  CFG_RESET_SPIN_LIMIT polls
+ * @details     Duration of each reset is recorded in device status.
  */
-void lldReset(
+int32_t lldReset(
     struct rtdm_device * dev);
 
+/**@brief       Get device status
+ * @param       dev
+ *              RT device descriptor
+ * @param       status
+ *              Copy of device status
+ */
+void lldStatusGet(
+    struct rtdm_device * dev,
+    struct xspiStatus * status);
+
 /**@brief       Enable FIFO on specified channel
  * @param       dev
  *              RT device descriptor
@@ -159,6 +245,21 @@ void lldChnTransferModeSet(
     uint32_t            chn,
     uint32_t            mode);
 
+/**@brief       Set TURBO mode
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       turbo
+ *              TRUE - next word is shifted while the previous one waits in Rx
+ *              register, only valid in receive only mode
+ *              FALSE - each word waits for the previous one to be read out
+ */
+void lldChnTurboSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    bool_T              turbo);
+
 /**@brief       Set pin layout
  * @param       dev
  *              RT device descriptor
@@ -186,6 +287,67 @@ void lldChnWordLengthSet(
     uint32_t            chn,
     uint32_t            wordLength);
 
+/**@brief       Compute clock divider for requested SPICLK frequency
+ * @param       ref
+ *              Functional clock frequency in Hz
+ * @param       freq
+ *              Requested SPICLK frequency in Hz
+ * @param       clk
+ *              Computed divider and achieved frequency
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EINVAL - requested frequency can't be reached
+ * @details     The highest frequency which does not exceed the requested one
+ *              is selected. Ratios up to 4096 are reached with one clock
+ *              cycle granularity (CLKG, EXTCLK and CLKD), higher ratios are
+ *              rounded up to a power of two (CLKD only, up to 32768).
+ */
+int32_t lldChnClkSolve(
+    uint32_t            ref,
+    uint32_t            freq,
+    struct lldChnClk *  clk);
+
+/**@brief       Set channel clock divider
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       clk
+ *              Divider computed by lldChnClkSolve()
+ */
+void lldChnClkSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const struct lldChnClk * clk);
+
+/**@brief       Compile current channel settings into a profile
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       profile
+ *              Compiled profile
+ */
+void lldChnProfileGet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    struct lldChnProfile * profile);
+
+/**@brief       Apply a compiled profile to a channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       profile
+ *              Profile compiled by lldChnProfileGet()
+ * @details     Registers are written only when their value changes, so
+ *              switching profiles usually costs one register write.
+ */
+void lldChnProfileSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const struct lldChnProfile * profile);
+
 /**@brief       Set CS delay
  * @param       dev
  *              RT device descriptor
@@ -233,6 +395,229 @@ int32_t lldChnCsStateSet(
     uint32_t            chn,
     uint32_t            state);
 
+/**@brief       Enable channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ */
+void lldChnEnable(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
+/**@brief       Disable channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ */
+void lldChnDisable(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
+/**@brief       Transfer words using programmed I/O
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       tx
+ *              Words to transmit, if NULL zeros are transmitted
+ * @param       rx
+ *              Storage for received words, if NULL received words are
+ *              discarded
+ * @param       words
+ *              Number of words to transfer
+ * @param       wordSize
+ *              Size of one word in buffers: 1, 2 or 4 bytes
+ * @return      Operation status
+ *              0 - success
+ *              -ETIMEDOUT - channel status did not change in time
+ * @details     The channel is enabled for the duration of transfer and the
+ *              function busy waits on TXS/RXS/EOT status bits. Direction of
+ *              transfer is taken from channel transfer mode. In receive only
+ *              TURBO mode the channel is disabled two words before the end.
+ */
+int32_t lldChnPioXfer(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+/**@brief       Get pending interrupt events
+ * @param       dev
+ *              RT device descriptor
+ * @return      Mask of pending LLD_IRQ_xxx events
+ */
+uint32_t lldIrqStatusGet(
+    struct rtdm_device * dev);
+
+/**@brief       Acknowledge interrupt events
+ * @param       dev
+ *              RT device descriptor
+ * @param       mask
+ *              Mask of LLD_IRQ_xxx events to acknowledge
+ */
+void lldIrqStatusClear(
+    struct rtdm_device * dev,
+    uint32_t            mask);
+
+/**@brief       Set which interrupt events are enabled
+ * @param       dev
+ *              RT device descriptor
+ * @param       mask
+ *              Mask of LLD_IRQ_xxx events to enable, all other events are
+ *              disabled
+ */
+void lldIrqEnableSet(
+    struct rtdm_device * dev,
+    uint32_t            mask);
+
+/**@brief       Get which interrupt events are enabled
+ * @param       dev
+ *              RT device descriptor
+ * @return      Mask of enabled LLD_IRQ_xxx events
+ */
+uint32_t lldIrqEnableGet(
+    struct rtdm_device * dev);
+
+/**@brief       Set FIFO transfer levels
+ * @param       dev
+ *              RT device descriptor
+ * @param       ael
+ *              Almost empty level in bytes: TX FIFO event is generated when
+ *              at least this many bytes are free, range 1 - LLD_FIFO_DEPTH
+ * @param       afl
+ *              Almost full level in bytes: RX FIFO event is generated when at
+ *              least this many bytes are received, range 1 - LLD_FIFO_DEPTH
+ * @param       wcnt
+ *              Number of words in transfer, 0 - counter is not used
+ */
+void lldXferLevelSet(
+    struct rtdm_device * dev,
+    uint32_t            ael,
+    uint32_t            afl,
+    uint32_t            wcnt);
+
+/**@brief       Write words into TX FIFO
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       tx
+ *              Words to transmit, if NULL zeros are transmitted
+ * @param       words
+ *              Number of words to write
+ * @param       wordSize
+ *              Size of one word in buffer: 1, 2 or 4 bytes
+ * @details     Status is not checked, the caller must know from FIFO events
+ *              that there is enough free space.
+ */
+void lldChnFifoWrite(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const void *        tx,
+    size_t              words,
+    uint32_t            wordSize);
+
+/**@brief       Read words from RX FIFO
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       rx
+ *              Storage for received words, if NULL words are discarded
+ * @param       words
+ *              Number of words to read
+ * @param       wordSize
+ *              Size of one word in buffer: 1, 2 or 4 bytes
+ * @details     Status is not checked, the caller must know from FIFO events
+ *              that there are enough words available.
+ */
+void lldChnFifoRead(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+/**@brief       Read words from RX FIFO, waiting for each word
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       rx
+ *              Storage for received words, if NULL words are discarded
+ * @param       words
+ *              Number of words to read
+ * @param       wordSize
+ *              Size of one word in buffer: 1, 2 or 4 bytes
+ * @return      Operation status
+ *              0 - success
+ *              -ETIMEDOUT - a word did not arrive in time
+ * @details     Used to collect the tail of a transfer which is too short to
+ *              raise a FIFO event.
+ */
+int32_t lldChnFifoDrain(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+/**@brief       Wait until the channel Tx register, Tx FIFO and shift register
+ *              are empty
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @return      Operation status
+ *              0 - success
+ *              -ETIMEDOUT - transfer did not end in time
+ */
+int32_t lldChnEotWait(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
+/**@brief       Enable or disable DMA requests of a channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @param       tx
+ *              TRUE - channel requests DMA write when Tx register is empty
+ * @param       rx
+ *              TRUE - channel requests DMA read when Rx register is full
+ */
+void lldChnDmaSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    bool_T              tx,
+    bool_T              rx);
+
+/**@brief       Get physical address of channel Tx register
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @return      Bus address used by DMA controller
+ */
+dma_addr_t lldChnTxAddrGet(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
+/**@brief       Get physical address of channel Rx register
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              Selected channel
+ * @return      Bus address used by DMA controller
+ */
+dma_addr_t lldChnRxAddrGet(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
 /*--------------------------------------------------------  C++ extern end  --*/
 #ifdef __cplusplus
 }
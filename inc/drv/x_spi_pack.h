@@ -0,0 +1,113 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Interface of word packing
+ * @details     Packed stream holds words of wordLength bits back to back, most
+ *              significant bit first. Driver buffers hold one word per 1, 2 or
+ *              4 byte slot in native byte order.
+ *********************************************************************//** @{ */
+
+#if !defined(X_SPI_PACK_H_)
+#define X_SPI_PACK_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "arch/compiler.h"
+
+/*===============================================================  MACRO's  ==*/
+
+/**@brief       Number of words which always end on a byte boundary of a packed
+ *              stream, regardless of word length
+ */
+#define PACK_WORD_ALIGN                 8u
+
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Get the number of words in a packed stream
+ * @param       bytes
+ *              Size of packed stream in bytes
+ * @param       wordLength
+ *              Data word length in bits, 4 - 32
+ * @param       words
+ *              Number of words in the stream
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EINVAL - stream does not end on a word boundary
+ */
+int32_t packWordsGet(
+    size_t              bytes,
+    uint32_t            wordLength,
+    size_t *            words);
+
+/**@brief       Expand packed stream into word slots
+ * @param       dst
+ *              Word slots, see xferWordSize()
+ * @param       src
+ *              Packed stream
+ * @param       words
+ *              Number of words
+ * @param       wordLength
+ *              Data word length in bits, 4 - 32
+ */
+void packUnpack(
+    void *              dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength);
+
+/**@brief       Pack word slots into a packed stream
+ * @param       dst
+ *              Packed stream
+ * @param       src
+ *              Word slots, see xferWordSize()
+ * @param       words
+ *              Number of words
+ * @param       wordLength
+ *              Data word length in bits, 4 - 32
+ * @details     Bits above word length in slots are ignored.
+ */
+void packPack(
+    void *              dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_pack.h
+ ******************************************************************************/
+#endif /* X_SPI_PACK_H_ */
@@ -0,0 +1,93 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Interface of word packing NEON loops
+ * @details     Shared with a compilation unit built with NEON enabled, it
+ *              uses only types of <stdint.h> and <stddef.h> and includes no
+ *              kernel headers.
+ *********************************************************************//** @{ */
+
+#if !defined(X_SPI_PACK_NEON_H_)
+#define X_SPI_PACK_NEON_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+/*===============================================================  MACRO's  ==*/
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Expand packed 12 or 24 bit stream into word slots
+ * @param       dst
+ *              Word slots
+ * @param       src
+ *              Packed stream
+ * @param       words
+ *              Number of words
+ * @param       wordLength
+ *              Data word length in bits
+ * @return      Number of words done, the rest is left to scalar loops
+ * @details     Must be called between kernel_neon_begin() and
+ *              kernel_neon_end().
+ */
+size_t packNeonUnpack(
+    void *              dst,
+    const uint8_t *     src,
+    size_t              words,
+    uint32_t            wordLength);
+
+/**@brief       Pack 12 or 24 bit word slots into a packed stream
+ * @param       dst
+ *              Packed stream
+ * @param       src
+ *              Word slots
+ * @param       words
+ *              Number of words
+ * @param       wordLength
+ *              Data word length in bits
+ * @return      Number of words done, the rest is left to scalar loops
+ * @details     Must be called between kernel_neon_begin() and
+ *              kernel_neon_end().
+ */
+size_t packNeonPack(
+    uint8_t *           dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_pack_neon.h
+ ******************************************************************************/
+#endif /* X_SPI_PACK_NEON_H_ */
@@ -0,0 +1,103 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Interface of transfer rings
+ *********************************************************************//** @{ */
+
+#if !defined(X_SPI_RING_H_)
+#define X_SPI_RING_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <rtdm/rtdm_driver.h>
+
+#include "arch/compiler.h"
+#include "drv/x_spi.h"
+
+/*===============================================================  MACRO's  ==*/
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Map transfer rings of a file descriptor into caller
+ * @param       fdCtx
+ *              File descriptor context
+ * @param       usr
+ *              User information of the caller
+ * @param       map
+ *              Requested geometry, on return holds address and size of mapping
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -ENOSYS - called from real-time context, retry from non RT
+ *              !0 - standard Linux error define
+ * @details     Rings are allocated on the first call. They are released when
+ *              the descriptor is closed and all mappings are removed.
+ */
+int32_t ringMap(
+    struct fdCtx *      fdCtx,
+    rtdm_user_info_t *  usr,
+    struct xspiRingMap * map);
+
+/**@brief       Release file descriptor reference to transfer rings
+ * @param       fdCtx
+ *              File descriptor context
+ */
+void ringTerm(
+    struct fdCtx *      fdCtx);
+
+/**@brief       Execute frames queued in Tx ring
+ * @param       dev
+ *              RT device descriptor
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which mapped the rings
+ * @param       chn
+ *              Channel used for transfer
+ * @return      Number of executed frames or standard Linux error define when
+ *              no frame was executed
+ * @details     At most one ring of frames is executed per call.
+ */
+int32_t ringKick(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_ring.h
+ ******************************************************************************/
+#endif /* X_SPI_RING_H_ */
@@ -0,0 +1,254 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Interface of transfer engines
+ *********************************************************************//** @{ */
+
+#if !defined(X_SPI_XFER_H_)
+#define X_SPI_XFER_H_
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <rtdm/rtdm_driver.h>
+
+#include "arch/compiler.h"
+#include "drv/x_spi.h"
+
+/*===============================================================  MACRO's  ==*/
+/*------------------------------------------------------  C++ extern begin  --*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================  DATA TYPES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*===================================================  FUNCTION PROTOTYPES  ==*/
+
+/**@brief       Initialize transfer engines of a device context
+ * @param       dev
+ *              RT device descriptor
+ * @param       devCtx
+ *              Device context
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              !0 - standard Linux error define
+ * @details     Requests module interrupt line.
+ */
+int32_t xferInit(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx);
+
+/**@brief       Terminate transfer engines of a device context
+ * @param       devCtx
+ *              Device context
+ */
+void xferTerm(
+    struct devCtx *     devCtx);
+
+/**@brief       Returns the size of one word in driver buffers
+ * @param       wordLength
+ *              Data word length in bits
+ * @return      Word size in bytes: 1, 2 or 4
+ */
+uint32_t xferWordSize(
+    uint32_t            wordLength);
+
+/**@brief       Execute a transfer on a channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       devCtx
+ *              Device context
+ * @param       chn
+ *              Channel used for transfer
+ * @param       tx
+ *              Kernel buffer with words to transmit, if NULL zeros are sent
+ * @param       rx
+ *              Kernel buffer for received words, if NULL they are discarded
+ * @param       bytes
+ *              Size of transfer in bytes, must be a multiple of word size
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              !0 - standard Linux error define
+ * @details     The function selects the transfer engine, executes the transfer
+ *              and updates channel statistics.
+ */
+int32_t xferRun(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              bytes);
+
+/**@brief       Execute a transfer by programmed I/O
+ * @param       devCtx
+ *              Device context
+ * @param       chn
+ *              Channel used for transfer
+ * @param       tx
+ *              Kernel buffer with words to transmit, if NULL zeros are sent
+ * @param       rx
+ *              Kernel buffer for received words, if NULL they are discarded
+ * @param       bytes
+ *              Size of transfer in bytes, must be a multiple of word size
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              !0 - standard Linux error define
+ * @details     Never sleeps, may be called from interrupt or timer context
+ *              with the bus claimed.
+ */
+int32_t xferPoll(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              bytes);
+
+/**@brief       Start a transfer without waiting for it to end
+ * @param       dev
+ *              RT device descriptor
+ * @param       devCtx
+ *              Device context
+ * @param       chn
+ *              Channel used for transfer
+ * @param       tx
+ *              Kernel buffer with words to transmit, if NULL zeros are sent
+ * @param       rx
+ *              Kernel buffer for received words, if NULL they are discarded
+ * @param       bytes
+ *              Size of transfer in bytes, must be a multiple of word size
+ * @param       complete
+ *              Function called from interrupt context when the transfer ends,
+ *              device lock is not held during the call
+ * @return      Operation status:
+ *              0 - SUCCESS, complete will be called
+ *              -EOPNOTSUPP - transfer can only be executed by xferRun()
+ *              !0 - standard Linux error define
+ */
+int32_t xferStart(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              bytes,
+    void             (* complete)(struct devCtx *, int32_t));
+
+/**@brief       Start slave streaming into pre-armed receive buffers
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which owns the streaming
+ * @param       chn
+ *              Channel which owns the FIFO
+ * @param       size
+ *              Size of one buffer in bytes, a multiple of word size
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EINVAL - invalid buffer size
+ *              -EOPNOTSUPP - module or channel is not set up for streaming
+ *              -EBUSY - streaming is already running
+ */
+int32_t xferSlaveStart(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    uint32_t            size);
+
+/**@brief       Stop slave streaming and discard buffers not read yet
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which stops the streaming
+ * @param       chn
+ *              Streaming channel
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EINVAL - streaming is not running on the channel
+ *              -EACCES - streaming was started by another descriptor
+ */
+int32_t xferSlaveStop(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn);
+
+/**@brief       Is slave streaming running on the channel
+ * @param       devCtx
+ *              Device context
+ * @param       chn
+ *              Channel
+ * @return      TRUE - streaming is running, FALSE - it is not
+ */
+bool_T xferSlaveIsRunning(
+    struct devCtx *     devCtx,
+    uint32_t            chn);
+
+/**@brief       Get unread data of the oldest filled buffer
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which reads the data
+ * @param       timeout
+ *              Wait timeout as for rtdm_event_timedwait()
+ * @param       data
+ *              Unread data of the buffer
+ * @param       bytes
+ *              Number of unread bytes, zero when streaming was stopped
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              -EACCES - streaming was started by another descriptor
+ *              !0 - standard Linux error define
+ */
+int32_t xferSlavePeek(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    nanosecs_rel_t      timeout,
+    const uint8_t **    data,
+    size_t *            bytes);
+
+/**@brief       Release bytes returned by xferSlavePeek()
+ * @param       devCtx
+ *              Device context
+ * @param       fdCtx
+ *              File descriptor which read the data
+ * @param       bytes
+ *              Number of bytes read, the buffer is rearmed when all are read,
+ *              ignored when streaming is no longer owned by fdCtx
+ */
+void xferSlaveConsume(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    size_t              bytes);
+
+/*--------------------------------------------------------  C++ extern end  --*/
+#ifdef __cplusplus
+}
+#endif
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_xfer.h
+ ******************************************************************************/
+#endif /* X_SPI_XFER_H_ */
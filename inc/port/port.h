@@ -29,9 +29,12 @@
 
 /*=========================================================  INCLUDE FILES  ==*/
 
+#include <linux/types.h>
 #include <rtdm/rtdm_driver.h>
 
 #include "arch/compiler.h"
+#include "drv/x_spi_cfg.h"
+#include "drv/x_spi_ioctl.h"
 
 /*===============================================================  MACRO's  ==*/
 /*------------------------------------------------------  C++ extern begin  --*/
@@ -41,13 +44,30 @@ extern "C" {
 
 /*============================================================  DATA TYPES  ==*/
 
+struct lldShadow;
+
 struct devData {
     struct addr {
         volatile uint8_t *  phy;
         uint8_t *           remap;
         size_t              size;
     }                   addr;
-    uint8_t *           shadow;
+    struct lldShadow *  shadow;                                                 /* Owned by low-level driver                                */
+    struct xspiStatus   stat;                                                   /* Low-level driver statistics                              */
+    uint32_t            irq;                                                    /* Interrupt line of the module                             */
+    uint32_t            clkFreq;                                                /* Functional clock frequency in Hz                         */
+};
+
+/**@brief       Description of one DMA transfer on a channel
+ */
+struct portDmaXfer {
+    dma_addr_t          txBuff;                                                 /* Source of Tx words, 0 if Tx is not used                  */
+    dma_addr_t          rxBuff;                                                 /* Destination of Rx words, 0 if Rx is not used             */
+    dma_addr_t          txReg;                                                  /* Physical address of channel Tx register                  */
+    dma_addr_t          rxReg;                                                  /* Physical address of channel Rx register                  */
+    size_t              words;                                                  /* Number of words, must be a multiple of burst             */
+    uint32_t            wordSize;                                               /* Size of one word in buffers: 1, 2 or 4 bytes             */
+    uint32_t            burst;                                                  /* Words moved per DMA request                              */
 };
 
 /*======================================================  GLOBAL VARIABLES  ==*/
@@ -133,6 +153,115 @@ uint32_t portChnIsOnline(
     struct rtdm_device * dev,
     uint32_t            chn);
 
+/**@brief       Returns interrupt line of device
+ * @param       dev
+ *              RT device descriptor
+ * @return      Interrupt number
+ */
+uint32_t portIrqGet(
+    struct rtdm_device * dev);
+
+/**@brief       Returns functional clock frequency of device
+ * @param       dev
+ *              RT device descriptor
+ * @return      Frequency in Hz
+ * @details     The frequency is read when the device is created, this
+ *              function can be called from real-time context.
+ */
+uint32_t portClkFreqGet(
+    struct rtdm_device * dev);
+
+#if (0u != CFG_DMA_MODE)
+/**@brief       Allocate DMA channels of a SPI channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              SPI channel number
+ * @param       done
+ *              Function called when a transfer ends. It is called from Linux
+ *              interrupt context with the status of transfer.
+ * @param       arg
+ *              Argument passed to done function
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              !0 - standard Linux error define
+ */
+int32_t portDmaChnCreate(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    void             (* done)(void *, int32_t),
+    void *              arg);
+
+/**@brief       Release DMA channels of a SPI channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              SPI channel number
+ */
+void portDmaChnDestroy(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
+/**@brief       Program and arm DMA channels of a SPI channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              SPI channel number
+ * @param       xfer
+ *              Transfer description
+ * @return      Operation status:
+ *              0 - SUCCESS
+ *              !0 - standard Linux error define
+ * @details     DMA channels wait for requests from the SPI channel. When Rx is
+ *              used the done function is called after the last word is
+ *              received, otherwise after the last word is written.
+ */
+int32_t portDmaChnStart(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const struct portDmaXfer * xfer);
+
+/**@brief       Stop DMA channels of a SPI channel
+ * @param       dev
+ *              RT device descriptor
+ * @param       chn
+ *              SPI channel number
+ */
+void portDmaChnStop(
+    struct rtdm_device * dev,
+    uint32_t            chn);
+
+/**@brief       Allocate a buffer which is accessible by DMA
+ * @param       dev
+ *              RT device descriptor
+ * @param       size
+ *              Size of buffer in bytes
+ * @param       handle
+ *              Bus address of the buffer
+ * @return      Pointer to the buffer or NULL if there is no memory
+ */
+void * portDmaBuffAlloc(
+    struct rtdm_device * dev,
+    size_t              size,
+    dma_addr_t *        handle);
+
+/**@brief       Free a buffer allocated with portDmaBuffAlloc()
+ * @param       dev
+ *              RT device descriptor
+ * @param       size
+ *              Size of buffer in bytes
+ * @param       buff
+ *              Pointer to the buffer
+ * @param       handle
+ *              Bus address of the buffer
+ */
+void portDmaBuffFree(
+    struct rtdm_device * dev,
+    size_t              size,
+    void *              buff,
+    dma_addr_t          handle);
+#endif
+
 /*--------------------------------------------------------  C++ extern end  --*/
 #ifdef __cplusplus
 }
@@ -29,6 +29,8 @@
 /*=========================================================  INCLUDE FILES  ==*/
 
 #include <linux/platform_device.h>
+#include <linux/dma-mapping.h>
+#include <linux/clk.h>
 #include <linux/pm_runtime.h>
 #include <plat/omap_device.h>
 #include <plat/mcspi.h>
@@ -45,6 +47,11 @@
 #define DEF_HWMOD_CLASS_NAME            "omap2_mcspi"
 #define DEF_HWMOD_DMA_TX                "tx"
 #define DEF_HWMOD_DMA_RX                "rx"
+#define DEF_HWMOD_FCLK                  "fck"
+
+/**@brief       Functional clock frequency used when it can't be read
+ */
+#define DEF_FCLK_FREQ                   48000000u
 
 /*======================================================  LOCAL DATA TYPES  ==*/
 
@@ -53,6 +60,9 @@ struct dmaData {
         int32_t             chn;
         int32_t             sync;
     }                   tx, rx;
+    void             (* done)(void *, int32_t);                                 /* Transfer completion callback                             */
+    void *              arg;
+    bool_T              rxActv;                                                 /* Completion is signalled by Rx channel                    */
 };
 
 struct privDevData {
@@ -84,6 +94,26 @@ static int32_t resRequest(
 static void resRelease(
     struct privDevData *    devData);
 
+#if (0u != CFG_DMA_MODE)
+static void dmaTxCallback(
+    unsigned            lch,
+    u16                 chStatus,
+    void *              data);
+
+static void dmaRxCallback(
+    unsigned            lch,
+    u16                 chStatus,
+    void *              data);
+
+static void dmaChnSetup(
+    int32_t             lch,
+    dma_addr_t          src,
+    s16                 srcIdx,
+    dma_addr_t          dst,
+    s16                 dstIdx,
+    const struct portDmaXfer * xfer);
+#endif
+
 /*=======================================================  LOCAL VARIABLES  ==*/
 /*======================================================  GLOBAL VARIABLES  ==*/
 /*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
@@ -110,6 +140,7 @@ static int32_t resRequest(
 
     int32_t             ret;
     struct resource *   res;
+    struct clk *        clk;
 #if (0u != CFG_DMA_MODE)
     uint32_t            cnt;
 #endif
@@ -150,6 +181,36 @@ static int32_t resRequest(
 
         return (-ENOMEM);
     }
+    ret = platform_get_irq(
+        devData->pDev,
+        0);
+
+    if (0 > ret) {
+        LOG_DBG("failed to get interrupt resource");
+        iounmap(
+            devData->public.addr.remap);
+        release_mem_region(
+            (resource_size_t)devData->public.addr.phy,
+            devData->public.addr.size);
+
+        return (-ENODEV);
+    }
+    devData->public.irq = (uint32_t)ret;
+    LOG_DBG("irq %d", devData->public.irq);
+    clk = clk_get(
+        &devData->pDev->dev,
+        DEF_HWMOD_FCLK);
+
+    if (IS_ERR(clk)) {
+        LOG_WARN("failed to get functional clock, assuming %d Hz", DEF_FCLK_FREQ);
+        devData->public.clkFreq = DEF_FCLK_FREQ;
+    } else {
+        devData->public.clkFreq = (uint32_t)clk_get_rate(
+            clk);
+        clk_put(
+            clk);
+    }
+    LOG_DBG("functional clock %d Hz", devData->public.clkFreq);
     ret = 0;
 #if (0u != CFG_DMA_MODE)
     devData->dma = kcalloc(
@@ -160,15 +221,14 @@ static int32_t resRequest(
     if (NULL == devData->dma) {
         LOG_DBG("failed to request memory for DMA management");
         iounmap(
-            devData->addr.remap);
+            devData->public.addr.remap);
         release_mem_region(
-            (resource_size_t)devData->addr.phy,
-            devData->addr.size);
+            (resource_size_t)devData->public.addr.phy,
+            devData->public.addr.size);
 
         return (-ENOMEM);
     }
 
-
     for (cnt = 0u; cnt < devData->online; cnt++) {
         char            resName[DEF_DRV_NAME_LEN];
 
@@ -205,7 +265,7 @@ static int32_t resRequest(
 
         if (NULL == res) {
             LOG_DBG("failed to get DMA Rx channel info");
-            ret = - ENODEV;
+            ret = -ENODEV;
             break;
         }
         devData->dma[cnt].rx.chn = EDMA_CHANNEL_ANY;
@@ -216,10 +276,10 @@ static int32_t resRequest(
     if (0 > ret) {
         LOG_DBG("failed to get DMA info");
         iounmap(
-            devData->addr.remap);
+            devData->public.addr.remap);
         release_mem_region(
-            (resource_size_t)devData->addr.phy,
-            devData->addr.size);
+            (resource_size_t)devData->public.addr.phy,
+            devData->public.addr.size);
         kfree(
             devData->dma);
     }
@@ -242,6 +302,114 @@ static void resRelease(
 #endif
 }
 
+#if (0u != CFG_DMA_MODE)
+/* NOTE: When both directions are used the Rx channel finishes last, so the Tx
+ *       channel reports only errors.
+ */
+static void dmaTxCallback(
+    unsigned            lch,
+    u16                 chStatus,
+    void *              data) {
+
+    struct dmaData *    dma;
+
+    dma = (struct dmaData *)data;
+
+    if (DMA_COMPLETE != chStatus) {
+        LOG_DBG("DMA Tx channel %d error", lch);
+        dma->done(
+            dma->arg,
+            -EIO);
+    } else if (FALSE == dma->rxActv) {
+        dma->done(
+            dma->arg,
+            0);
+    }
+}
+
+static void dmaRxCallback(
+    unsigned            lch,
+    u16                 chStatus,
+    void *              data) {
+
+    struct dmaData *    dma;
+
+    dma = (struct dmaData *)data;
+
+    if (DMA_COMPLETE != chStatus) {
+        LOG_DBG("DMA Rx channel %d error", lch);
+        dma->done(
+            dma->arg,
+            -EIO);
+    } else {
+        dma->done(
+            dma->arg,
+            0);
+    }
+}
+
+/* NOTE: A single burst is transferred as A-synchronized array per request,
+ *       longer bursts as AB-synchronized frames of burst words. The channel
+ *       slot starts with the dummy parameter set and edma_set_*() don't touch
+ *       completion bits, so transfer complete interrupt and its code are
+ *       enabled here, otherwise the callbacks would never run.
+ */
+static void dmaChnSetup(
+    int32_t             lch,
+    dma_addr_t          src,
+    s16                 srcIdx,
+    dma_addr_t          dst,
+    s16                 dstIdx,
+    const struct portDmaXfer * xfer) {
+
+    struct edmacc_param param;
+
+    edma_set_src(
+        (unsigned)lch,
+        src,
+        INCR,
+        W8BIT);
+    edma_set_dest(
+        (unsigned)lch,
+        dst,
+        INCR,
+        W8BIT);
+    edma_set_src_index(
+        (unsigned)lch,
+        srcIdx,
+        (s16)(srcIdx * xfer->burst));
+    edma_set_dest_index(
+        (unsigned)lch,
+        dstIdx,
+        (s16)(dstIdx * xfer->burst));
+
+    if (1u == xfer->burst) {
+        edma_set_transfer_params(
+            (unsigned)lch,
+            (u16)xfer->wordSize,
+            (u16)xfer->words,
+            1u,
+            (u16)xfer->words,
+            ASYNC);
+    } else {
+        edma_set_transfer_params(
+            (unsigned)lch,
+            (u16)xfer->wordSize,
+            (u16)xfer->burst,
+            (u16)(xfer->words / xfer->burst),
+            (u16)xfer->burst,
+            ABSYNC);
+    }
+    edma_read_slot(
+        (unsigned)lch,
+        &param);
+    param.opt |= TCINTEN | EDMA_TCC(EDMA_CHAN_SLOT(lch));
+    edma_write_slot(
+        (unsigned)lch,
+        &param);
+}
+#endif
+
 /*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
 /*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
 
@@ -428,6 +596,203 @@ bool_T portChnIsOnline(
     }
 }
 
+uint32_t portIrqGet(
+    struct rtdm_device * dev) {
+
+    struct privDevData *    devData;
+
+    devData = getPrivDevData(
+        dev);
+
+    return (devData->public.irq);
+}
+
+uint32_t portClkFreqGet(
+    struct rtdm_device * dev) {
+
+    struct privDevData *    devData;
+
+    devData = getPrivDevData(
+        dev);
+
+    return (devData->public.clkFreq);
+}
+
+#if (0u != CFG_DMA_MODE)
+int32_t portDmaChnCreate(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    void             (* done)(void *, int32_t),
+    void *              arg) {
+
+    struct privDevData *    devData;
+    struct dmaData *    dma;
+    int                 retval;
+
+    devData = getPrivDevData(
+        dev);
+    dma = &devData->dma[chn];
+    dma->done = done;
+    dma->arg = arg;
+    dma->rxActv = FALSE;
+    retval = edma_alloc_channel(
+        dma->tx.sync,
+        dmaTxCallback,
+        dma,
+        EVENTQ_0);
+
+    if (0 > retval) {
+        LOG_ERR("failed to allocate DMA Tx channel %d, err: %d", dma->tx.sync, -retval);
+
+        return ((int32_t)retval);
+    }
+    dma->tx.chn = (int32_t)retval;
+    retval = edma_alloc_channel(
+        dma->rx.sync,
+        dmaRxCallback,
+        dma,
+        EVENTQ_0);
+
+    if (0 > retval) {
+        LOG_ERR("failed to allocate DMA Rx channel %d, err: %d", dma->rx.sync, -retval);
+        edma_free_channel(
+            (unsigned)dma->tx.chn);
+        dma->tx.chn = EDMA_CHANNEL_ANY;
+
+        return ((int32_t)retval);
+    }
+    dma->rx.chn = (int32_t)retval;
+
+    return (0);
+}
+
+void portDmaChnDestroy(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    struct privDevData *    devData;
+    struct dmaData *    dma;
+
+    devData = getPrivDevData(
+        dev);
+    dma = &devData->dma[chn];
+
+    if (EDMA_CHANNEL_ANY != dma->rx.chn) {
+        edma_free_channel(
+            (unsigned)dma->rx.chn);
+        dma->rx.chn = EDMA_CHANNEL_ANY;
+    }
+
+    if (EDMA_CHANNEL_ANY != dma->tx.chn) {
+        edma_free_channel(
+            (unsigned)dma->tx.chn);
+        dma->tx.chn = EDMA_CHANNEL_ANY;
+    }
+}
+
+int32_t portDmaChnStart(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const struct portDmaXfer * xfer) {
+
+    struct privDevData *    devData;
+    struct dmaData *    dma;
+    int                 retval;
+
+    devData = getPrivDevData(
+        dev);
+    dma = &devData->dma[chn];
+    dma->rxActv = (0u != xfer->rxBuff) ? TRUE : FALSE;
+
+    if (0u != xfer->rxBuff) {
+        dmaChnSetup(
+            dma->rx.chn,
+            xfer->rxReg,
+            0,
+            xfer->rxBuff,
+            (s16)xfer->wordSize,
+            xfer);
+        retval = edma_start(
+            (unsigned)dma->rx.chn);
+
+        if (0 != retval) {
+
+            return ((int32_t)retval);
+        }
+    }
+
+    if (0u != xfer->txBuff) {
+        dmaChnSetup(
+            dma->tx.chn,
+            xfer->txBuff,
+            (s16)xfer->wordSize,
+            xfer->txReg,
+            0,
+            xfer);
+        retval = edma_start(
+            (unsigned)dma->tx.chn);
+
+        if (0 != retval) {
+
+            if (TRUE == dma->rxActv) {
+                edma_stop(
+                    (unsigned)dma->rx.chn);
+            }
+
+            return ((int32_t)retval);
+        }
+    }
+
+    return (0);
+}
+
+void portDmaChnStop(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    struct privDevData *    devData;
+    struct dmaData *    dma;
+
+    devData = getPrivDevData(
+        dev);
+    dma = &devData->dma[chn];
+    edma_stop(
+        (unsigned)dma->tx.chn);
+    edma_stop(
+        (unsigned)dma->rx.chn);
+}
+
+void * portDmaBuffAlloc(
+    struct rtdm_device * dev,
+    size_t              size,
+    dma_addr_t *        handle) {
+
+    struct privDevData *    devData;
+
+    devData = getPrivDevData(
+        dev);
+
+    return (dma_alloc_coherent(&devData->pDev->dev, size, handle, GFP_KERNEL));
+}
+
+void portDmaBuffFree(
+    struct rtdm_device * dev,
+    size_t              size,
+    void *              buff,
+    dma_addr_t          handle) {
+
+    struct privDevData *    devData;
+
+    devData = getPrivDevData(
+        dev);
+    dma_free_coherent(
+        &devData->pDev->dev,
+        size,
+        buff,
+        handle);
+}
+#endif
+
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
 /** @endcond *//** @} *//******************************************************
  * END of plat_omap2.c
@@ -30,11 +30,18 @@
 
 #include "linux/module.h"
 #include "linux/printk.h"
+#include "linux/mutex.h"
+#include "linux/slab.h"
 
 #include "arch/compiler.h"
 #include "drv/x_spi_ioctl.h"
 #include "drv/x_spi_cfg.h"
 #include "drv/x_spi_lld.h"
+#include "drv/x_spi_xfer.h"
+#include "drv/x_spi_ring.h"
+#include "drv/x_spi_job.h"
+#include "drv/x_spi_pack.h"
+#include "drv/x_spi_cyclic.h"
 #include "drv/x_spi.h"
 #include "port/port.h"
 #include "dbg/dbg.h"
@@ -45,7 +52,6 @@
 #define DEF_DEVCTX_SIGNATURE            0xdeadbeefu
 
 #define XSPI_ACTIVITY_IDLE              0u
-#define XSPI_ACTIVITY_RUNNIG               (!XSPI_ACTIVITY_IDLE)
 #define XSPI_ACTIVITY_ID(chn)           (0x01u << (chn))
 
 #define CFG_ARG_IS_VALID(argv, min, max)                                        \
@@ -87,10 +93,16 @@ DECL_MODULE_INFO(DEF_DRV_NAME, DEF_DRV_DESCRIPTION, DEF_DRV_AUTHOR);
 
 static struct rtdm_device * Devs[CFG_MAX_DEVICES];
 
+static struct devCtx * DevCtxs[CFG_MAX_DEVICES];
+
+/**@brief       Serializes creation and destruction of shared device contexts
+ */
+static DEFINE_MUTEX(DevCtxsLock);
+
 static const struct rtdm_device DevTemplate = {
     .struct_version     = RTDM_DEVICE_STRUCT_VER,
-    .device_flags       = RTDM_NAMED_DEVICE | RTDM_EXCLUSIVE,
-    .context_size       = sizeof(struct devCtx),
+    .device_flags       = RTDM_NAMED_DEVICE,
+    .context_size       = sizeof(struct fdCtx),
     .device_name        = DEF_DRV_NAME,
     .protocol_family    = 0,
     .socket_type        = 0,
@@ -134,10 +146,179 @@ MODULE_SUPPORTED_DEVICE(DEF_DRV_SUPP_DEVICE);
 
 /*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
 
+static struct fdCtx * getFdCtx(
+    struct rtdm_dev_context * rtdmDevCtx) {
+
+    return ((struct fdCtx *)&rtdmDevCtx->dev_private[0]);
+}
+
 static struct devCtx * getDevCtx(
     struct rtdm_dev_context * rtdmDevCtx) {
 
-    return ((struct devCtx *)&rtdmDevCtx->dev_private[0]);
+    return (getFdCtx(rtdmDevCtx)->devCtx);
+}
+
+static enum xspiChn getChn(
+    struct rtdm_dev_context * rtdmDevCtx) {
+
+    return (getFdCtx(rtdmDevCtx)->chn);
+}
+
+/* NOTE: Device lock must be held.
+ */
+static bool_T chnIsAccessible(
+    struct rtdm_dev_context * rtdmDevCtx,
+    enum xspiChn        chn) {
+
+    struct fdCtx *      owner;
+
+    owner = getDevCtx(rtdmDevCtx)->chn[chn].owner;
+
+    if ((NULL == owner) || (getFdCtx(rtdmDevCtx) == owner)) {
+
+        return (TRUE);
+    }
+
+    return (FALSE);
+}
+
+/* NOTE: Device lock must be held. Device-global settings may change only when
+ *       no channel is active.
+ */
+static bool_T devIsIdle(
+    struct devCtx *     devCtx) {
+
+    uint32_t            i;
+
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
+
+        if (XSPI_ACTIVITY_IDLE != devCtx->chn[i].actvCnt) {
+
+            return (FALSE);
+        }
+    }
+
+    return (TRUE);
+}
+
+/* NOTE: Configuration of an active channel is locked until chnActvPut() is
+ *       called, other channels can still be configured.
+ */
+static int32_t chnActvGet(
+    struct rtdm_dev_context * ctx,
+    enum xspiChn        chn) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, chn)) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+    devCtx->chn[chn].actvCnt++;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static void chnActvPut(
+    struct rtdm_dev_context * ctx,
+    enum xspiChn        chn) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    devCtx->chn[chn].actvCnt--;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+}
+
+static uint32_t getDevId(
+    struct rtdm_device * dev) {
+
+    uint32_t            i;
+
+    for (i = 0u; i < CFG_MAX_DEVICES; i++) {
+
+        if (dev == Devs[i]) {
+
+            break;
+        }
+    }
+
+    return (i);
+}
+
+/* NOTE: Bus is claimed in priority order, the mutex also boosts the priority of
+ *       current bus owner to the priority of the highest waiter.
+ */
+static int32_t busGet(
+    struct devCtx *     devCtx) {
+
+    int32_t             ret;
+
+    ret = rtdm_mutex_lock(
+        &devCtx->busLock);
+
+    if (0 != ret) {
+
+        return (ret);
+    }
+    ret = jobBusGet(
+        devCtx);
+
+    if (0 != ret) {
+        rtdm_mutex_unlock(
+            &devCtx->busLock);
+    }
+
+    return (ret);
+}
+
+static void busPut(
+    struct devCtx *     devCtx) {
+
+    jobBusPut(
+        devCtx);
+    rtdm_mutex_unlock(
+        &devCtx->busLock);
+}
+
+static int usrCopyFrom(
+    rtdm_user_info_t *  usr,
+    void *              dst,
+    const void __user * src,
+    size_t              bytes) {
+
+    if (NULL != usr) {
+
+        return (rtdm_safe_copy_from_user(usr, dst, src, bytes));
+    }
+    memcpy(dst, src, bytes);
+
+    return (0);
+}
+
+static int usrCopyTo(
+    rtdm_user_info_t *  usr,
+    void __user *       dst,
+    const void *        src,
+    size_t              bytes) {
+
+    if (NULL != usr) {
+
+        return (rtdm_safe_copy_to_user(usr, dst, src, bytes));
+    }
+    memcpy(dst, src, bytes);
+
+    return (0);
 }
 
 static void unitCtxInit(
@@ -149,25 +330,56 @@ static int32_t ctxInit(
     struct rtdm_dev_context * ctx) {
 
     struct devCtx *     devCtx;
+    uint32_t            fclk;
     uint32_t            i;
     int32_t             ret;
 
     ret = 0;
     devCtx = getDevCtx(
         ctx);
+    devCtx->cfg.fifoChn      = XSPI_FIFO_CHN_DISABLED;
+    devCtx->cfg.csMode       = XSPI_CS_MODE_ENABLED;
+    devCtx->cfg.mode         = XSPI_MODE_MASTER;
+    devCtx->cfg.channelMode  = XSPI_CHANNEL_MODE_MULTI;
+    devCtx->cfg.delay        = XSPI_INITIAL_DELAY_0;
+    devCtx->cfg.pioThreshold = CFG_PIO_THRESHOLD;
+    fclk = portClkFreqGet(
+        ctx->device);
 
     for (i = 0u; i < DEF_CHN_COUNT; i++) {
         devCtx->chn[i].online = FALSE;
+        devCtx->chn[i].owner  = NULL;
+        devCtx->chn[i].actvCnt = XSPI_ACTIVITY_IDLE;
 
         if (TRUE == portChnIsOnline(ctx->device, i)) {
             devCtx->chn[i].online = TRUE;
         }
+        devCtx->chn[i].cfg.transferMode = XSPI_TRANSFER_MODE_TX_AND_RX;
+        devCtx->chn[i].cfg.pinLayout    = XSPI_PIN_LAYOUT_TX_RX;
+        devCtx->chn[i].cfg.csDelay      = XSPI_CS_DELAY_0_5;
+        devCtx->chn[i].cfg.csPolarity   = XSPI_CS_POLARITY_ACTIVE_HIGH;
+        devCtx->chn[i].cfg.csState      = XSPI_CS_STATE_INACTIVE;
+        devCtx->chn[i].cfg.wordLength   = 8u;
+        devCtx->chn[i].cfg.clockFreq    = fclk;                                 /* Reset value of divider is 1                              */
+        (void)lldChnClkSolve(
+            fclk,
+            fclk,
+            &devCtx->chn[i].cfg.clk);
+        devCtx->chn[i].cfg.jobWeight    = 1u;
+        devCtx->chn[i].cfg.xferLevel    = 0u;
+        devCtx->chn[i].cfg.packing      = XSPI_PACKING_NONE;
+        memset(&devCtx->chn[i].stat, 0, sizeof(devCtx->chn[i].stat));
+    }
+
+    for (i = 0u; i < CFG_CHN_PROFILES; i++) {
+        devCtx->profile[i].valid = FALSE;
     }
     rtdm_lock_init(&devCtx->lock);
-    rtdm_sem_init(
-        &devCtx->actvLock,
-        1ul);
-    devCtx->actvCnt     = 0u;
+    seqcount_init(
+        &devCtx->statSeq);
+    rtdm_mutex_init(
+        &devCtx->busLock);
+    devCtx->users       = 0u;
     ES_DBG_API_OBLIGATION(devCtx->signature = DEF_DEVCTX_SIGNATURE);
 
     return (ret);
@@ -176,18 +388,52 @@ static int32_t ctxInit(
 static void ctxTerm(
     struct rtdm_dev_context * ctx) {
 
+    struct devCtx *     devCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_mutex_destroy(
+        &devCtx->busLock);
 }
 
 static int32_t cfgApply(
     struct rtdm_dev_context * ctx) {
 
     struct devCtx *     devCtx;
+    uint32_t            i;
+    int32_t             ret;
 
     devCtx = getDevCtx(
         ctx);
-    lldReset(ctx->device);
+    lldBatchBegin(ctx->device);
+    write_seqcount_begin(
+        &devCtx->statSeq);
+    ret = lldReset(ctx->device);
+    write_seqcount_end(
+        &devCtx->statSeq);
+
+    if (0 != ret) {
+        lldBatchCommit(ctx->device);
+
+        return (ret);
+    }
     lldModeSet(ctx->device, devCtx->cfg.mode);
 
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
+
+        if (TRUE == devCtx->chn[i].online) {
+            lldChnWordLengthSet(                                                /* Reset value of word length is not valid                  */
+                ctx->device,
+                i,
+                devCtx->chn[i].cfg.wordLength);
+            lldChnClkSet(
+                ctx->device,
+                i,
+                &devCtx->chn[i].cfg.clk);
+        }
+    }
+    lldBatchCommit(ctx->device);
+
     return (0);
 }
 
@@ -195,10 +441,40 @@ static int32_t cfgChnSet(
     struct rtdm_dev_context * ctx,
     enum xspiChn        chn) {
 
+    LOG_DBG("CFG: set current channel to %d", chn);
+
+    if (!CFG_ARG_IS_VALID(chn, XSPI_CHN_0, XSPI_CHN_3)) {
+
+        return (-EINVAL);
+    }
+
+    if (FALSE == portChnIsOnline(ctx->device, chn)) {
+
+        return (-EIDRM);
+    }
+    getFdCtx(ctx)->chn = chn;
+
+    return (0);
+}
+
+static void cfgChnGet(
+    struct rtdm_dev_context * ctx,
+    enum xspiChn *      chn) {
+
+    *chn = getChn(
+        ctx);
+
+    LOG_DBG("CFG: current channel is %d", *chn);
+}
+
+static int32_t cfgChnClaim(
+    struct rtdm_dev_context * ctx,
+    enum xspiChn        chn) {
+
     struct devCtx *     devCtx;
     rtdm_lockctx_t      lockCtx;
 
-    LOG_DBG("CFG: set current channel to %d", chn);
+    LOG_DBG("CFG: claim channel %d", chn);
 
     if (!CFG_ARG_IS_VALID(chn, XSPI_CHN_0, XSPI_CHN_3)) {
 
@@ -212,23 +488,44 @@ static int32_t cfgChnSet(
     devCtx = getDevCtx(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
-    devCtx->cfg.chn = chn;
+
+    if (FALSE == chnIsAccessible(ctx, chn)) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EBUSY);
+    }
+    devCtx->chn[chn].owner = getFdCtx(ctx);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
     return (0);
 }
 
-static void cfgChnGet(
+static int32_t cfgChnRelease(
     struct rtdm_dev_context * ctx,
-    enum xspiChn *      chn) {
+    enum xspiChn        chn) {
 
     struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: release channel %d", chn);
 
+    if (!CFG_ARG_IS_VALID(chn, XSPI_CHN_0, XSPI_CHN_3)) {
+
+        return (-EINVAL);
+    }
     devCtx = getDevCtx(
         ctx);
-    *chn = devCtx->cfg.chn;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (getFdCtx(ctx) != devCtx->chn[chn].owner) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EPERM);
+    }
+    devCtx->chn[chn].owner = NULL;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
-    LOG_DBG("CFG: current channel is %d", devCtx->cfg.chn);
+    return (0);
 }
 
 static int32_t cfgFIFOChnSet(
@@ -256,7 +553,7 @@ static int32_t cfgFIFOChnSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == devIsIdle(devCtx)) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
@@ -310,7 +607,7 @@ static int32_t cfgCsModeSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == devIsIdle(devCtx)) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
@@ -338,12 +635,17 @@ static void cfgCsModeGet(
     *csMode = devCtx->cfg.csMode;
 }
 
+/* NOTE: Switching the mode does not reset the module, all other settings are
+ *       preserved. Channels are disabled before MODULCTRL is changed and a
+ *       forced CS is released since it is valid only in master mode.
+ */
 static int32_t cfgModeSet(
     struct rtdm_dev_context * ctx,
     enum xspiMode       mode) {
 
     struct devCtx *     devCtx;
     rtdm_lockctx_t      lockCtx;
+    uint32_t            i;
 
     LOG_DBG("CFG: set SPI mode to %d", mode);
 
@@ -355,14 +657,38 @@ static int32_t cfgModeSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == devIsIdle(devCtx)) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
+
+    if (mode == devCtx->cfg.mode) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (0);
+    }
+    lldBatchBegin(ctx->device);
+
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
+
+        if (TRUE == devCtx->chn[i].online) {
+            lldChnDisable(
+                ctx->device,
+                i);
+
+            if (XSPI_CS_STATE_ACTIVE == devCtx->chn[i].cfg.csState) {
+                (void)lldChnCsStateSet(
+                    ctx->device,
+                    i,
+                    XSPI_CS_STATE_INACTIVE);
+                devCtx->chn[i].cfg.csState = XSPI_CS_STATE_INACTIVE;
+            }
+        }
+    }
     devCtx->cfg.mode = mode;
-    cfgApply(
-        ctx);
+    lldModeSet(ctx->device, mode);
+    lldBatchCommit(ctx->device);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
     return (0);
@@ -377,9 +703,9 @@ static void cfgModeGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: CS mode is %d", devCtx->cfg.csMode);
+    LOG_DBG("CFG: mode is %d", devCtx->cfg.mode);
 
-    *mode = devCtx->cfg.csMode;
+    *mode = devCtx->cfg.mode;
 }
 
 static int32_t cfgChannelModeSet(
@@ -389,7 +715,7 @@ static int32_t cfgChannelModeSet(
     struct devCtx *     devCtx;
     rtdm_lockctx_t      lockCtx;
 
-    LOG_DBG("CFG: set initial delay to %d", channelMode);
+    LOG_DBG("CFG: set channel mode to %d", channelMode);
 
     if (!CFG_ARG_IS_VALID(channelMode, XSPI_CHANNEL_MODE_MULTI, XSPI_CHANNEL_MODE_SINGLE)) {
 
@@ -399,12 +725,12 @@ static int32_t cfgChannelModeSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == devIsIdle(devCtx)) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->cfg.delay = channelMode;
+    devCtx->cfg.channelMode = channelMode;
     lldChannelModeSet(
         ctx->device,
         (uint32_t)channelMode);
@@ -444,7 +770,7 @@ static int32_t cfgInitialDelaySet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == devIsIdle(devCtx)) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
@@ -489,15 +815,21 @@ static int32_t cfgChnTransferModeSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->chn[devCtx->cfg.chn].cfg.transferMode = transferMode;
+    devCtx->chn[getChn(ctx)].cfg.transferMode = transferMode;
     lldChnTransferModeSet(
         ctx->device,
-        devCtx->cfg.chn,
+        getChn(ctx),
         (uint32_t)transferMode);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
@@ -513,9 +845,9 @@ static void cfgChnTransferModeGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: transfer mode is %d", devCtx->chn[devCtx->cfg.chn].cfg.transferMode);
+    LOG_DBG("CFG: transfer mode is %d", devCtx->chn[getChn(ctx)].cfg.transferMode);
 
-    *transferMode = devCtx->chn[devCtx->cfg.chn].cfg.transferMode;
+    *transferMode = devCtx->chn[getChn(ctx)].cfg.transferMode;
 }
 
 static int32_t cfgChnPinLayoutSet(
@@ -535,15 +867,21 @@ static int32_t cfgChnPinLayoutSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->chn[devCtx->cfg.chn].cfg.pinLayout = pinLayout;
+    devCtx->chn[getChn(ctx)].cfg.pinLayout = pinLayout;
     lldChnPinLayoutSet(
         ctx->device,
-        devCtx->cfg.chn,
+        getChn(ctx),
         (uint32_t)pinLayout);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
@@ -559,9 +897,9 @@ static void cfgChnPinLayoutGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: pin layout is %d", devCtx->chn[devCtx->cfg.chn].cfg.pinLayout);
+    LOG_DBG("CFG: pin layout is %d", devCtx->chn[getChn(ctx)].cfg.pinLayout);
 
-    *pinLayout = devCtx->chn[devCtx->cfg.chn].cfg.pinLayout;
+    *pinLayout = devCtx->chn[getChn(ctx)].cfg.pinLayout;
 }
 
 static int32_t cfgChnWordLengthSet(
@@ -581,15 +919,21 @@ static int32_t cfgChnWordLengthSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->chn[devCtx->cfg.chn].cfg.wordLength = length;
-    lldChnCsDelaySet(
+    devCtx->chn[getChn(ctx)].cfg.wordLength = length;
+    lldChnWordLengthSet(
         ctx->device,
-        devCtx->cfg.chn,
+        getChn(ctx),
         (uint32_t)length);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
@@ -605,9 +949,72 @@ static void cfgChnWordLengthGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: word length is %d", devCtx->chn[devCtx->cfg.chn].cfg.wordLength);
+    LOG_DBG("CFG: word length is %d", devCtx->chn[getChn(ctx)].cfg.wordLength);
+
+    *length = devCtx->chn[getChn(ctx)].cfg.wordLength;
+}
+
+/* NOTE: The divider is computed once, outside of the lock, and only the cached
+ *       register values are written to the channel.
+ */
+static int32_t cfgChnClockFreqSet(
+    struct rtdm_dev_context * ctx,
+    uint32_t            freq) {
+
+    struct devCtx *     devCtx;
+    struct lldChnClk    clk;
+    rtdm_lockctx_t      lockCtx;
+    int32_t             ret;
+
+    LOG_DBG("CFG: set clock frequency to %d", freq);
+
+    ret = lldChnClkSolve(
+        portClkFreqGet(ctx->device),
+        freq,
+        &clk);
+
+    if (0 != ret) {
+
+        return (ret);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EAGAIN);
+    }
+    devCtx->chn[getChn(ctx)].cfg.clockFreq = freq;
+    devCtx->chn[getChn(ctx)].cfg.clk       = clk;
+    lldChnClkSet(
+        ctx->device,
+        getChn(ctx),
+        &clk);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static void cfgChnClockFreqGet(
+    struct rtdm_dev_context * ctx,
+    uint32_t *          freq) {
+
+    struct devCtx *     devCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    LOG_DBG("CFG: clock frequency is %d", devCtx->chn[getChn(ctx)].cfg.clk.freq);
 
-    *length = devCtx->chn[devCtx->cfg.chn].cfg.wordLength;
+    *freq = devCtx->chn[getChn(ctx)].cfg.clk.freq;
 }
 
 static int32_t cfgChnCsDelaySet(
@@ -627,15 +1034,21 @@ static int32_t cfgChnCsDelaySet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->chn[devCtx->cfg.chn].cfg.csDelay = delay;
+    devCtx->chn[getChn(ctx)].cfg.csDelay = delay;
     lldChnCsDelaySet(
         ctx->device,
-        devCtx->cfg.chn,
+        getChn(ctx),
         (uint32_t)delay);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
@@ -651,9 +1064,9 @@ static void cfgChnCsDelayGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: CS delay is %d", devCtx->chn[devCtx->cfg.chn].cfg.csDelay);
+    LOG_DBG("CFG: CS delay is %d", devCtx->chn[getChn(ctx)].cfg.csDelay);
 
-    *delay = devCtx->chn[devCtx->cfg.chn].cfg.csDelay;
+    *delay = devCtx->chn[getChn(ctx)].cfg.csDelay;
 }
 
 static int32_t cfgChnCsPolaritySet(
@@ -673,15 +1086,21 @@ static int32_t cfgChnCsPolaritySet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->chn[devCtx->cfg.chn].cfg.wordLength = csPolarity;
+    devCtx->chn[getChn(ctx)].cfg.csPolarity = csPolarity;
     lldChnCsPolaritySet(
         ctx->device,
-        devCtx->cfg.chn,
+        getChn(ctx),
         (uint32_t)csPolarity);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
@@ -697,9 +1116,9 @@ static void cfgChnCsPolarityGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: CS polarity is %d", devCtx->chn[devCtx->cfg.chn].cfg.csPolarity);
+    LOG_DBG("CFG: CS polarity is %d", devCtx->chn[getChn(ctx)].cfg.csPolarity);
 
-    *csPolarity =  devCtx->chn[devCtx->cfg.chn].cfg.csPolarity;
+    *csPolarity =  devCtx->chn[getChn(ctx)].cfg.csPolarity;
 }
 
 static int32_t cfgChnCsStateSet(
@@ -720,15 +1139,21 @@ static int32_t cfgChnCsStateSet(
         ctx);
     rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    if (XSPI_ACTIVITY_RUNNIG == devCtx->actvCnt) {
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
         rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
         return (-EAGAIN);
     }
-    devCtx->chn[devCtx->cfg.chn].cfg.csState = state;
+    devCtx->chn[getChn(ctx)].cfg.csState = state;
     ret = lldChnCsStateSet(
         ctx->device,
-        devCtx->cfg.chn,
+        getChn(ctx),
         (uint32_t)state);
     rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
 
@@ -744,70 +1169,931 @@ static void cfgChnCsStateGet(
     devCtx = getDevCtx(
         ctx);
 
-    LOG_DBG("CFG: CS state is %d", devCtx->chn[devCtx->cfg.chn].cfg.csState);
+    LOG_DBG("CFG: CS state is %d", devCtx->chn[getChn(ctx)].cfg.csState);
 
-    *state = devCtx->chn[devCtx->cfg.chn].cfg.csState;
+    *state = devCtx->chn[getChn(ctx)].cfg.csState;
 }
 
-/*
- * Rest
+static int32_t cfgChnProfileSave(
+    struct rtdm_dev_context * ctx,
+    uint32_t            profile) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: save profile %d", profile);
+
+    if (CFG_CHN_PROFILES <= profile) {
+
+        return (-EINVAL);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    devCtx->profile[profile].cfg = devCtx->chn[getChn(ctx)].cfg;
+    lldChnProfileGet(
+        ctx->device,
+        getChn(ctx),
+        &devCtx->profile[profile].regs);
+    devCtx->profile[profile].valid = TRUE;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+/* NOTE: CS state and job weight belong to the channel and not to the
+ *       profile, they are kept when a profile is loaded.
  */
+static int32_t cfgChnProfileLoad(
+    struct rtdm_dev_context * ctx,
+    uint32_t            profile) {
 
-/******************************************************************************
- * DMA MODE 0
- ******************************************************************************/
-#if (0u == CFG_DMA_MODE)
+    struct devCtx *     devCtx;
+    struct chnCgf *     chnCfg;
+    enum xspiCsState    csState;
+    uint32_t            jobWeight;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: load profile %d", profile);
+
+    if (CFG_CHN_PROFILES <= profile) {
+
+        return (-EINVAL);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (FALSE == devCtx->profile[profile].valid) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EINVAL);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EAGAIN);
+    }
+    chnCfg  = &devCtx->chn[getChn(ctx)].cfg;
+    csState = chnCfg->csState;
+    jobWeight = chnCfg->jobWeight;
+    *chnCfg = devCtx->profile[profile].cfg;
+    chnCfg->csState = csState;
+    chnCfg->jobWeight = jobWeight;
+    lldChnProfileSet(
+        ctx->device,
+        getChn(ctx),
+        &devCtx->profile[profile].regs);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static int32_t cfgChnJobWeightSet(
+    struct rtdm_dev_context * ctx,
+    uint32_t            weight) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: set job weight to %d", weight);
+
+    if (!CFG_ARG_IS_VALID(weight, 1u, 255u)) {
+
+        return (-EINVAL);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+    devCtx->chn[getChn(ctx)].cfg.jobWeight = weight;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static void cfgChnJobWeightGet(
+    struct rtdm_dev_context * ctx,
+    uint32_t *          weight) {
+
+    struct devCtx *     devCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    LOG_DBG("CFG: job weight is %d", devCtx->chn[getChn(ctx)].cfg.jobWeight);
+
+    *weight = devCtx->chn[getChn(ctx)].cfg.jobWeight;
+}
+
+static int32_t cfgChnXferLevelSet(
+    struct rtdm_dev_context * ctx,
+    uint32_t            level) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: set FIFO level to %d", level);
+
+    if ((LLD_FIFO_DEPTH / 2u) < level) {
+
+        return (-EINVAL);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EAGAIN);
+    }
+    devCtx->chn[getChn(ctx)].cfg.xferLevel = level;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static void cfgChnXferLevelGet(
+    struct rtdm_dev_context * ctx,
+    uint32_t *          level) {
+
+    struct devCtx *     devCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    LOG_DBG("CFG: FIFO level is %d", devCtx->chn[getChn(ctx)].cfg.xferLevel);
+
+    *level = devCtx->chn[getChn(ctx)].cfg.xferLevel;
+}
+
+static int32_t cfgChnPackingSet(
+    struct rtdm_dev_context * ctx,
+    enum xspiPacking    packing) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: set packing to %d", packing);
+
+    if (!CFG_ARG_IS_VALID(packing, XSPI_PACKING_NONE, XSPI_PACKING_MSB_FIRST)) {
+
+        return (-EINVAL);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EAGAIN);
+    }
+    devCtx->chn[getChn(ctx)].cfg.packing = packing;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static void cfgChnPackingGet(
+    struct rtdm_dev_context * ctx,
+    enum xspiPacking *  packing) {
+
+    struct devCtx *     devCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    LOG_DBG("CFG: packing is %d", devCtx->chn[getChn(ctx)].cfg.packing);
+
+    *packing = devCtx->chn[getChn(ctx)].cfg.packing;
+}
+
+static int32_t cfgPioThresholdSet(
+    struct rtdm_dev_context * ctx,
+    uint32_t            threshold) {
+
+    struct devCtx *     devCtx;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("CFG: set PIO threshold to %d", threshold);
+
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    devCtx->cfg.pioThreshold = threshold;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+static void cfgPioThresholdGet(
+    struct rtdm_dev_context * ctx,
+    uint32_t *          threshold) {
+
+    struct devCtx *     devCtx;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    LOG_DBG("CFG: PIO threshold is %d", devCtx->cfg.pioThreshold);
+
+    *threshold = devCtx->cfg.pioThreshold;
+}
+
+static void chnStatusGet(
+    struct rtdm_dev_context * ctx,
+    struct xspiChnStatus * status) {
+
+    struct devCtx *     devCtx;
+    struct chnCtx *     chnCtx;
+    uint32_t            seq;
+
+    devCtx = getDevCtx(
+        ctx);
+    chnCtx = &devCtx->chn[getChn(ctx)];
+
+    do {
+        seq = read_seqcount_begin(
+            &devCtx->statSeq);
+        *status = chnCtx->stat;
+    } while (0 != read_seqcount_retry(&devCtx->statSeq, seq));
+}
+
+static void devStatusGet(
+    struct rtdm_dev_context * ctx,
+    struct xspiStatus * status) {
+
+    struct devCtx *     devCtx;
+    uint32_t            seq;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    do {
+        seq = read_seqcount_begin(
+            &devCtx->statSeq);
+        lldStatusGet(
+            ctx->device,
+            status);
+    } while (0 != read_seqcount_retry(&devCtx->statSeq, seq));
+}
+
+/* NOTE: User buffers are moved through driver buffers in chunks of
+ *       CFG_XFER_BUFF_SIZE bytes. NULL src sends zeros and NULL dst discards
+ *       received words.
+ * NOTE: When preempt is TRUE the bus is claimed for each chunk separately, so
+ *       a higher priority client waits at most one chunk. Configuration of the
+ *       channel stays locked for the whole transfer. Otherwise the caller owns
+ *       the bus.
+ * NOTE: Channel status timestamps are written by the transfer engine for each
+ *       chunk. While the bus is still held after a chunk, start time is moved
+ *       back to the start of the first chunk, so status covers the transfer.
+ */
+static ssize_t chnXfer(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    const void __user * src,
+    void __user *       dst,
+    size_t              bytes,
+    bool_T              preempt,
+    nanosecs_abs_t *    timeStart,
+    nanosecs_abs_t *    timeEnd) {
+
+    struct devCtx *     devCtx;
+    struct xspiChnStatus * stat;
+    enum xspiTransferMode mode;
+    enum xspiChn        chn;
+    nanosecs_abs_t      start;
+    nanosecs_abs_t      end;
+    uint32_t            pack;
+    uint32_t            wordSize;
+    size_t              words;
+    ssize_t             done;
+    int32_t             ret;
+
+    devCtx = getDevCtx(
+        ctx);
+    done = 0;
+    chn = getChn(ctx);
+    stat = &devCtx->chn[chn].stat;
+    start = 0u;
+    end = 0u;
+
+/*-- Set activity: disable configuration -------------------------------------*/
+    ret = chnActvGet(
+        ctx,
+        chn);
+
+    if (0 != ret) {
+
+        return (ret);
+    }
+    mode = devCtx->chn[chn].cfg.transferMode;
+    pack = (XSPI_PACKING_NONE != devCtx->chn[chn].cfg.packing) ?
+        devCtx->chn[chn].cfg.wordLength : 0u;
+    wordSize = xferWordSize(
+        devCtx->chn[chn].cfg.wordLength);
+
+    if (((NULL != src) && (XSPI_TRANSFER_MODE_RX_ONLY == mode)) ||
+        ((NULL != dst) && (XSPI_TRANSFER_MODE_TX_ONLY == mode))) {
+        ret = -EPERM;
+    } else if (0u != pack) {
+        ret = packWordsGet(
+            bytes,
+            pack,
+            &words);
+    }
+
+    while ((0 == ret) && ((size_t)done < bytes)) {
+        size_t          chunk;
+        size_t          slots;
+
+        if (0u == pack) {
+            chunk = min_t(size_t, bytes - (size_t)done, CFG_XFER_BUFF_SIZE);
+            slots = chunk;
+        } else {                                                                /* Whole chunks end on a byte boundary of the stream        */
+            words = min_t(size_t, ((bytes - (size_t)done) * 8u) / pack, CFG_XFER_BUFF_SIZE / wordSize);
+            chunk = (words * pack) / 8u;
+            slots = words * wordSize;
+        }
+
+        if (TRUE == preempt) {
+            ret = busGet(
+                devCtx);
+
+            if (0 != ret) {
+
+                break;
+            }
+        }
+
+        if (NULL != src) {
+            ret = usrCopyFrom(
+                usr,
+                (0u != pack) ? devCtx->buff.stream : devCtx->buff.tx,
+                (const uint8_t __user *)src + done,
+                chunk);
+
+            if ((0 == ret) && (0u != pack)) {
+                packUnpack(
+                    devCtx->buff.tx,
+                    devCtx->buff.stream,
+                    words,
+                    pack);
+            }
+        }
+
+        if (0 == ret) {
+            ret = xferRun(
+                ctx->device,
+                devCtx,
+                chn,
+                (NULL != src) ? devCtx->buff.tx : NULL,
+                (NULL != dst) ? devCtx->buff.rx : NULL,
+                slots);
+        }
+
+        if (0 == ret) {
+            rtdm_lockctx_t lockCtx;
+
+            rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+            if (0 == done) {
+                start = stat->timeStart;
+            } else {
+                write_seqcount_begin(
+                    &devCtx->statSeq);
+                stat->timeStart = start;
+                write_seqcount_end(
+                    &devCtx->statSeq);
+            }
+            end = stat->timeEnd;
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        }
+
+        if ((0 == ret) && (NULL != dst)) {
+
+            if (0u != pack) {
+                packPack(
+                    devCtx->buff.stream,
+                    devCtx->buff.rx,
+                    words,
+                    pack);
+            }
+            ret = usrCopyTo(
+                usr,
+                (uint8_t __user *)dst + done,
+                (0u != pack) ? devCtx->buff.stream : devCtx->buff.rx,
+                chunk);
+        }
+
+        if (TRUE == preempt) {
+            busPut(
+                devCtx);
+        }
+
+        if (0 == ret) {
+            done += (ssize_t)chunk;
+        }
+    }
+
+/*-- Reset activity: enable configuration ------------------------------------*/
+    chnActvPut(
+        ctx,
+        chn);
+
+    if (NULL != timeStart) {
+        *timeStart = start;
+    }
+
+    if (NULL != timeEnd) {
+        *timeEnd = end;
+    }
+
+    if ((0 != ret) && (0 == done)) {
+        done = ret;
+    }
+
+    return (done);
+}
+
+/* NOTE: Reads whole samples, waits only when no sample is stored yet. Returns
+ *       zero when acquisition is stopped while waiting.
+ */
+static ssize_t chnCyclicRead(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    void __user *       dst,
+    size_t              bytes) {
+
+    struct devCtx *     devCtx;
+    enum xspiChn        chn;
+    size_t              count;
+    size_t              done;
+    int32_t             ret;
+
+    devCtx = getDevCtx(
+        ctx);
+    chn = getChn(ctx);
+    count = bytes / sizeof(struct xspiSample);
+
+    if (0u == count) {
+
+        return (-EINVAL);
+    }
+    done = 0u;
+    ret = 0;
+
+    while (done < count) {
+        const struct xspiSample * samples;
+        size_t          avail;
+
+        ret = cyclicPeek(
+            devCtx,
+            getFdCtx(ctx),
+            chn,
+            (0u == done) ? 0 : -1,
+            &samples,
+            &avail);
+
+        if ((0 != ret) || (0u == avail)) {
+
+            break;
+        }
+        avail = min_t(size_t, avail, count - done);
+        ret = usrCopyTo(
+            usr,
+            (uint8_t __user *)dst + (done * sizeof(struct xspiSample)),
+            samples,
+            avail * sizeof(struct xspiSample));
+
+        if (0 != ret) {
+
+            break;
+        }
+        cyclicConsume(
+            devCtx,
+            getFdCtx(ctx),
+            chn,
+            avail);
+        done += avail;
+    }
+
+    if (0u != done) {
+
+        return ((ssize_t)(done * sizeof(struct xspiSample)));
+    }
+
+    return (ret);
+}
+
+/* NOTE: Reads any number of bytes from filled buffers, waits only when no
+ *       buffer is filled yet. Returns zero when streaming is stopped while
+ *       waiting.
+ */
+static ssize_t chnSlaveRead(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    void __user *       dst,
+    size_t              bytes) {
+
+    struct devCtx *     devCtx;
+    size_t              done;
+    int32_t             ret;
+
+    devCtx = getDevCtx(
+        ctx);
+    done = 0u;
+    ret = 0;
+
+    while (done < bytes) {
+        const uint8_t * data;
+        size_t          avail;
+
+        ret = xferSlavePeek(
+            devCtx,
+            getFdCtx(ctx),
+            (0u == done) ? 0 : -1,
+            &data,
+            &avail);
+
+        if ((0 != ret) || (0u == avail)) {
+
+            break;
+        }
+        avail = min_t(size_t, avail, bytes - done);
+        ret = usrCopyTo(
+            usr,
+            (uint8_t __user *)dst + done,
+            data,
+            avail);
+
+        if (0 != ret) {
+
+            break;
+        }
+        xferSlaveConsume(
+            devCtx,
+            getFdCtx(ctx),
+            avail);
+        done += avail;
+    }
+
+    if (0u != done) {
+
+        return ((ssize_t)done);
+    }
+
+    return (ret);
+}
+
+/* NOTE: Settings are checked, stored and committed to the hardware in one hold
+ *       of the device lock. The batch never stays open while the lock is
+ *       released, so register changes made by other descriptors are written
+ *       right away and never deferred into this commit.
+ */
+static int32_t chnSettingsApply(
+    struct rtdm_dev_context * ctx,
+    uint32_t            wordLength,
+    uint32_t            clockFreq,
+    enum xspiCsState    csState) {
+
+    rtdm_lockctx_t      lockCtx;
+    struct devCtx *     devCtx;
+    struct chnCgf *     chnCfg;
+    struct lldChnClk    clk;
+    int32_t             ret;
+
+    if (!CFG_ARG_IS_VALID(wordLength, 4u, 32u)) {
+
+        return (-EINVAL);
+    }
+    devCtx = getDevCtx(
+        ctx);
+    chnCfg = &devCtx->chn[getChn(ctx)].cfg;
+    clk = chnCfg->clk;
+    ret = 0;
+
+    if (clockFreq != chnCfg->clockFreq) {
+        ret = lldChnClkSolve(
+            portClkFreqGet(ctx->device),
+            clockFreq,
+            &clk);
+
+        if (0 != ret) {
+
+            return (ret);
+        }
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == chnIsAccessible(ctx, getChn(ctx))) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (XSPI_ACTIVITY_IDLE != devCtx->chn[getChn(ctx)].actvCnt) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EAGAIN);
+    }
+    lldBatchBegin(
+        ctx->device);
+
+    if (wordLength != chnCfg->wordLength) {
+        chnCfg->wordLength = wordLength;
+        lldChnWordLengthSet(
+            ctx->device,
+            getChn(ctx),
+            wordLength);
+    }
+
+    if (clockFreq != chnCfg->clockFreq) {
+        chnCfg->clockFreq = clockFreq;
+        chnCfg->clk       = clk;
+        lldChnClkSet(
+            ctx->device,
+            getChn(ctx),
+            &clk);
+    }
+
+    if (csState != chnCfg->csState) {
+        chnCfg->csState = csState;
+        ret = lldChnCsStateSet(
+            ctx->device,
+            getChn(ctx),
+            (uint32_t)csState);
+    }
+    lldBatchCommit(
+        ctx->device);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (ret);
+}
+
+/* NOTE: All segment settings are committed to the hardware at once, right
+ *       before the segment is transferred.
+ */
+static int32_t chnSegmentApply(
+    struct rtdm_dev_context * ctx,
+    const struct xspiSegment * segment) {
+
+    struct devCtx *     devCtx;
+    enum xspiCsState    csState;
+
+    devCtx = getDevCtx(
+        ctx);
+    csState = devCtx->chn[getChn(ctx)].cfg.csState;
+
+    if (XSPI_CHANNEL_MODE_SINGLE == devCtx->cfg.channelMode) {
+        csState = XSPI_CS_STATE_ACTIVE;
+    }
+
+    return (chnSettingsApply(
+        ctx,
+        segment->wordLength,
+        segment->clockFreq,
+        csState));
+}
+
+/* NOTE: Segment settings are applied through the configuration functions and
+ *       the channel configuration is restored when the message ends. Chip
+ *       select is forced only in single channel mode, in multi channel mode
+ *       segments asking to keep CS asserted are rejected.
+ */
+static int32_t chnMessage(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    const struct xspiMessage * msg) {
+
+    struct devCtx *     devCtx;
+    struct chnCgf *     chnCfg;
+    uint32_t            wordLength;
+    uint32_t            clockFreq;
+    enum xspiCsState    csState;
+    uint32_t            cnt;
+    int32_t             ret;
+
+    devCtx = getDevCtx(
+        ctx);
+    chnCfg = &devCtx->chn[getChn(ctx)].cfg;
+    wordLength = chnCfg->wordLength;
+    clockFreq = chnCfg->clockFreq;
+    csState = chnCfg->csState;
+    ret = 0;
+
+    for (cnt = 0u; (0 == ret) && (cnt < msg->count); cnt++) {
+        struct xspiSegment segment;
+        ssize_t         done;
+
+        ret = usrCopyFrom(
+            usr,
+            &segment,
+            &msg->segments[cnt],
+            sizeof(segment));
+
+        if (0 != ret) {
+
+            break;
+        }
+
+        if ((0u != segment.csKeep) &&
+            (XSPI_CHANNEL_MODE_SINGLE != devCtx->cfg.channelMode)) {
+            ret = -EPERM;
+
+            break;
+        }
+
+        if (0u == segment.wordLength) {
+            segment.wordLength = wordLength;
+        }
+
+        if (0u == segment.clockFreq) {
+            segment.clockFreq = clockFreq;
+        }
+        ret = chnSegmentApply(
+            ctx,
+            &segment);
+
+        if (0 != ret) {
+
+            break;
+        }
+        done = chnXfer(
+            ctx,
+            usr,
+            segment.tx,
+            segment.rx,
+            segment.length,
+            FALSE,
+            NULL,
+            NULL);
+
+        if (0 > done) {
+            ret = (int32_t)done;
+        } else if ((size_t)done != segment.length) {
+            ret = -EIO;
+        } else if ((0u == segment.csKeep) &&
+                   (XSPI_CS_STATE_ACTIVE == chnCfg->csState)) {
+            ret = cfgChnCsStateSet(
+                ctx,
+                XSPI_CS_STATE_INACTIVE);
+        }
+    }
+
+    if ((0 != ret) && (XSPI_CS_STATE_ACTIVE == chnCfg->csState) &&
+        (XSPI_CS_STATE_ACTIVE != csState)) {
+        csState = XSPI_CS_STATE_INACTIVE;
+    } else {
+        csState = chnCfg->csState;
+    }
+    (void)chnSettingsApply(
+        ctx,
+        wordLength,
+        clockFreq,
+        csState);
+
+    return (ret);
+}
+
+/* NOTE: Job requests are executed without disabling communication or claiming
+ *       the bus, so they can be posted while jobs or other transfers run.
+ */
+static int32_t jobIOctl(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    unsigned int        req,
+    void __user *       arg) {
+
+    rtdm_lockctx_t      lockCtx;
+    struct devCtx *     devCtx;
+    struct xspiJob      desc;
+    uint8_t             buff[CFG_JOB_BUFF_SIZE];
+    uint32_t            chn;
+    int32_t             ret;
+
+    devCtx = getDevCtx(
+        ctx);
+
+    if (XSPI_IOC_JOB_SUBMIT == req) {
+        ret = usrCopyFrom(
+            usr,
+            &desc,
+            arg,
+            sizeof(desc));
+        chn = (0 > desc.chn) ? (uint32_t)getChn(ctx) : (uint32_t)desc.chn;
 
-static int handleOpen(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    int                 oflag) {
+        if ((0 == ret) && ((0u == desc.length) || (CFG_JOB_BUFF_SIZE < desc.length))) {
+            ret = -EINVAL;
+        }
 
-    int                 retval;
+        if ((0 == ret) && (DEF_CHN_COUNT > chn)) {
+            rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-    retval = 0;
+            if (FALSE == chnIsAccessible(ctx, (enum xspiChn)chn)) {
+                ret = -EACCES;
+            }
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        }
 
-    return (retval);
-}
+        if ((0 == ret) && (NULL != desc.tx)) {
+            ret = usrCopyFrom(
+                usr,
+                buff,
+                desc.tx,
+                desc.length);
+        }
 
-static int handleClose(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr) {
+        if (0 == ret) {
+            ret = jobSubmit(
+                devCtx,
+                getFdCtx(ctx),
+                chn,
+                &desc,
+                (NULL != desc.tx) ? buff : NULL);
+        }
+    } else {
+        struct xspiJobResult result;
+
+        ret = usrCopyFrom(
+            usr,
+            &result,
+            arg,
+            sizeof(result));
+
+        if (0 == ret) {
+            ret = jobReap(
+                devCtx,
+                getFdCtx(ctx),
+                (nanosecs_rel_t)result.timeout,
+                &desc,
+                &result.status,
+                buff);
+        }
 
-    int                 retval;
+        if ((0 == ret) && (NULL != desc.rx)) {
+            ret = usrCopyTo(
+                usr,
+                desc.rx,
+                buff,
+                desc.length);
+        }
 
-    retval = 0;
+        if (0 == ret) {
+            result.tag = desc.tag;
+            ret = usrCopyTo(
+                usr,
+                arg,
+                &result,
+                sizeof(result));
+        }
+    }
 
-    return (retval);
+    return (ret);
 }
 
-static int handleIOctl(
+/* NOTE: Getters do not claim the bus nor take the device lock, they never wait
+ *       for transfers or add latency to them. Status snapshots are read under
+ *       the status sequence counter.
+ */
+static int32_t getIOctl(
     struct rtdm_dev_context * ctx,
     rtdm_user_info_t *  usr,
     unsigned int        req,
     void __user *       arg) {
 
-    struct devCtx *     devCtx;
     int                 retval;
 
     retval = 0;
-    devCtx = getDevCtx(
-        ctx);
-
-/*-- Set activity: disable communication -------------------------------------*/
-    rtdm_sem_down(
-        &devCtx->actvLock);
 
     switch (req) {
-/*-- XSPI_IOC_SET_CURRENT_CHN ------------------------------------------------*/
-        case XSPI_IOC_SET_CURRENT_CHN : {
-            retval = (int)cfgChnSet(
-                ctx,
-                (enum xspiChn)arg);
-
-            break;
-        }
-
 /*-- XSPI_IOC_GET_CURRENT_CHN ------------------------------------------------*/
         case XSPI_IOC_GET_CURRENT_CHN : {
             enum xspiChn chn;
@@ -829,15 +2115,6 @@ static int handleIOctl(
             break;
         }
 
-/*-- XSPI_IOC_SET_FIFO_MODE --------------------------------------------------*/
-        case XSPI_IOC_SET_FIFO_CHN : {
-            retval = (int)cfgFIFOChnSet(
-                ctx,
-                (enum xspiFifoChn)arg);
-
-            break;
-        }
-
 /*-- XSPI_IOC_GET_FIFO_MODE --------------------------------------------------*/
         case XSPI_IOC_GET_FIFO_CHN : {
             enum xspiFifoChn fifoChn;
@@ -859,15 +2136,6 @@ static int handleIOctl(
             break;
         }
 
-/*-- XSPI_IOC_SET_CS_MODE ----------------------------------------------------*/
-        case XSPI_IOC_SET_CS_MODE : {
-            retval = (int)cfgCsModeSet(
-                ctx,
-                (enum xspiCsMode)arg);
-
-            break;
-        }
-
 /*-- XSPI_IOC_GET_CS_MODE ----------------------------------------------------*/
         case XSPI_IOC_GET_CS_MODE : {
             enum xspiCsMode csMode;
@@ -889,15 +2157,6 @@ static int handleIOctl(
             break;
         }
 
-/*-- XSPI_IOC_SET_MODE -------------------------------------------------------*/
-        case XSPI_IOC_SET_MODE : {
-            retval = (int)cfgModeSet(
-                ctx,
-                (enum xspiMode)arg);
-
-            break;
-        }
-
 /*-- XSPI_IOC_GET_MODE -------------------------------------------------------*/
         case XSPI_IOC_GET_MODE : {
             enum xspiMode mode;
@@ -919,15 +2178,6 @@ static int handleIOctl(
             break;
         }
 
-/*-- XSPI_IOC_SET_CHANNEL_MODE -----------------------------------------------*/
-        case XSPI_IOC_SET_CHANNEL_MODE : {
-            retval = (int)cfgChannelModeSet(
-                ctx,
-                (enum xspiChannelMode)arg);
-
-            break;
-        }
-
 /*-- XSPI_IOC_GET_CHANNEL_MODE -----------------------------------------------*/
         case XSPI_IOC_GET_CHANNEL_MODE : {
             enum xspiChannelMode channelMode;
@@ -949,15 +2199,6 @@ static int handleIOctl(
             break;
         }
 
-/*-- XSPI_IOC_SET_INITIAL_DELAY ----------------------------------------------*/
-        case XSPI_IOC_SET_INITIAL_DELAY : {
-            retval = (int)cfgInitialDelaySet(
-                ctx,
-                (enum xspiInitialDelay)arg);
-
-            break;
-        }
-
 /*-- XSPI_IOC_GET_INITIAL_DELAY ----------------------------------------------*/
         case XSPI_IOC_GET_INITIAL_DELAY : {
             enum xspiInitialDelay initialDelay;
@@ -970,101 +2211,333 @@ static int handleIOctl(
                 retval = rtdm_safe_copy_to_user(
                     usr,
                     arg,
-                    &initialDelay,
+                    &initialDelay,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)initialDelay;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_TRANSFER_MODE ----------------------------------------------*/
+        case XSPI_IOC_GET_TRANSFER_MODE : {
+            enum xspiTransferMode transferMode;
+
+            cfgChnTransferModeGet(
+                ctx,
+                &transferMode);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &transferMode,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)transferMode;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_PIN_LAYOUT -------------------------------------------------*/
+        case XSPI_IOC_GET_PIN_LAYOUT : {
+            enum xspiPinLayout pinLayout;
+
+            cfgChnPinLayoutGet(
+                ctx,
+                &pinLayout);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &pinLayout,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)pinLayout;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_WORD_LENGTH ------------------------------------------------*/
+        case XSPI_IOC_GET_WORD_LENGTH : {
+            uint32_t    wordLength;
+
+            cfgChnWordLengthGet(
+                ctx,
+                &wordLength);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &wordLength,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)wordLength;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_CS_DELAY ---------------------------------------------------*/
+        case XSPI_IOC_GET_CS_DELAY : {
+            enum xspiCsDelay csDelay;
+
+            cfgChnCsDelayGet(
+                ctx,
+                &csDelay);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &csDelay,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)csDelay;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_CS_POLARITY ------------------------------------------------*/
+        case XSPI_IOC_GET_CS_POLARITY : {
+            enum xspiCsPolarity csPolarity;
+
+            cfgChnCsPolarityGet(
+                ctx,
+                &csPolarity);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &csPolarity,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)csPolarity;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_CS_STATE ---------------------------------------------------*/
+        case XSPI_IOC_GET_CS_STATE : {
+            enum xspiCsState csState;
+
+            cfgChnCsStateGet(
+                ctx,
+                &csState);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &csState,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)csState;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_PIO_THRESHOLD ----------------------------------------------*/
+        case XSPI_IOC_GET_PIO_THRESHOLD : {
+            uint32_t    threshold;
+
+            cfgPioThresholdGet(
+                ctx,
+                &threshold);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &threshold,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)threshold;
+            }
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_STATUS -----------------------------------------------------*/
+        case XSPI_IOC_GET_STATUS : {
+            struct xspiStatus status;
+
+            devStatusGet(
+                ctx,
+                &status);
+            retval = usrCopyTo(
+                usr,
+                arg,
+                &status,
+                sizeof(status));
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_CHN_STATUS -------------------------------------------------*/
+        case XSPI_IOC_GET_CHN_STATUS : {
+            struct xspiChnStatus status;
+
+            chnStatusGet(
+                ctx,
+                &status);
+            retval = usrCopyTo(
+                usr,
+                arg,
+                &status,
+                sizeof(status));
+
+            break;
+        }
+
+/*-- XSPI_IOC_GET_CLOCK_FREQ -------------------------------------------------*/
+        case XSPI_IOC_GET_CLOCK_FREQ : {
+            uint32_t    clockFreq;
+
+            cfgChnClockFreqGet(
+                ctx,
+                &clockFreq);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &clockFreq,
                     sizeof(int));
             } else {
-                *(int *)arg = (int)initialDelay;
+                *(int *)arg = (int)clockFreq;
             }
 
             break;
         }
 
-/*-- XSPI_IOC_SET_TRANSFER_MODE ----------------------------------------------*/
-        case XSPI_IOC_SET_TRANSFER_MODE : {
-            retval = (int)cfgChnTransferModeSet(
-                ctx,
-                (enum xspiTransferMode)arg);
-
-            break;
-        }
-
-/*-- XSPI_IOC_GET_TRANSFER_MODE ----------------------------------------------*/
-        case XSPI_IOC_GET_TRANSFER_MODE : {
-            enum xspiTransferMode transferMode;
+/*-- XSPI_IOC_GET_JOB_WEIGHT -------------------------------------------------*/
+        case XSPI_IOC_GET_JOB_WEIGHT : {
+            uint32_t    weight;
 
-            cfgChnTransferModeGet(
+            cfgChnJobWeightGet(
                 ctx,
-                &transferMode);
+                &weight);
 
             if (NULL != usr) {
                 retval = rtdm_safe_copy_to_user(
                     usr,
                     arg,
-                    &transferMode,
+                    &weight,
                     sizeof(int));
             } else {
-                *(int *)arg = (int)transferMode;
+                *(int *)arg = (int)weight;
             }
 
             break;
         }
 
-/*-- XSPI_IOC_SET_PIN_LAYOUT -------------------------------------------------*/
-        case XSPI_IOC_SET_PIN_LAYOUT : {
-            retval = (int)cfgChnPinLayoutSet(
+/*-- XSPI_IOC_GET_XFER_LEVEL -------------------------------------------------*/
+        case XSPI_IOC_GET_XFER_LEVEL : {
+            uint32_t    level;
+
+            cfgChnXferLevelGet(
                 ctx,
-                (enum xspiPinLayout)arg);
+                &level);
+
+            if (NULL != usr) {
+                retval = rtdm_safe_copy_to_user(
+                    usr,
+                    arg,
+                    &level,
+                    sizeof(int));
+            } else {
+                *(int *)arg = (int)level;
+            }
 
             break;
         }
 
-/*-- XSPI_IOC_GET_PIN_LAYOUT -------------------------------------------------*/
-        case XSPI_IOC_GET_PIN_LAYOUT : {
-            enum xspiPinLayout pinLayout;
+/*-- XSPI_IOC_GET_PACKING ----------------------------------------------------*/
+        case XSPI_IOC_GET_PACKING : {
+            enum xspiPacking packing;
 
-            cfgChnPinLayoutGet(
+            cfgChnPackingGet(
                 ctx,
-                &pinLayout);
+                &packing);
 
             if (NULL != usr) {
                 retval = rtdm_safe_copy_to_user(
                     usr,
                     arg,
-                    &pinLayout,
+                    &packing,
                     sizeof(int));
             } else {
-                *(int *)arg = (int)pinLayout;
+                *(int *)arg = (int)packing;
             }
 
             break;
         }
 
-/*-- XSPI_IOC_SET_WORD_LENGTH ------------------------------------------------*/
-        case XSPI_IOC_SET_WORD_LENGTH : {
-            retval = (int)cfgChnWordLengthSet(
+/*-- Not a getter ------------------------------------------------------------*/
+        default : {
+            retval = -ENOTTY;
+        }
+    }
+
+    return ((int32_t)retval);
+}
+
+/* NOTE: Channel settings do not claim the bus. They are refused only while the
+ *       channel itself is active, so other channels keep transferring.
+ */
+static int32_t chnIOctl(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    unsigned int        req,
+    void __user *       arg) {
+
+    int                 retval;
+
+    retval = 0;
+
+    switch (req) {
+/*-- XSPI_IOC_SET_CURRENT_CHN ------------------------------------------------*/
+        case XSPI_IOC_SET_CURRENT_CHN : {
+            retval = (int)cfgChnSet(
                 ctx,
-                (uint32_t)arg);
+                (enum xspiChn)arg);
 
             break;
         }
 
-/*-- XSPI_IOC_GET_WORD_LENGTH ------------------------------------------------*/
-        case XSPI_IOC_GET_WORD_LENGTH : {
-            uint32_t    wordLength;
+/*-- XSPI_IOC_SET_TRANSFER_MODE ----------------------------------------------*/
+        case XSPI_IOC_SET_TRANSFER_MODE : {
+            retval = (int)cfgChnTransferModeSet(
+                ctx,
+                (enum xspiTransferMode)arg);
 
-            cfgChnWordLengthGet(
+            break;
+        }
+
+/*-- XSPI_IOC_SET_PIN_LAYOUT -------------------------------------------------*/
+        case XSPI_IOC_SET_PIN_LAYOUT : {
+            retval = (int)cfgChnPinLayoutSet(
                 ctx,
-                &wordLength);
+                (enum xspiPinLayout)arg);
 
-            if (NULL != usr) {
-                retval = rtdm_safe_copy_to_user(
-                    usr,
-                    arg,
-                    &wordLength,
-                    sizeof(int));
-            } else {
-                *(int *)arg = (int)wordLength;
-            }
+            break;
+        }
+
+/*-- XSPI_IOC_SET_WORD_LENGTH ------------------------------------------------*/
+        case XSPI_IOC_SET_WORD_LENGTH : {
+            retval = (int)cfgChnWordLengthSet(
+                ctx,
+                (uint32_t)arg);
 
             break;
         }
@@ -1078,290 +2551,670 @@ static int handleIOctl(
             break;
         }
 
-/*-- XSPI_IOC_GET_CS_DELAY ---------------------------------------------------*/
-        case XSPI_IOC_GET_CS_DELAY : {
-            enum xspiCsDelay csDelay;
-
-            cfgChnCsDelayGet(
+/*-- XSPI_IOC_SET_CS_POLARITY ------------------------------------------------*/
+        case XSPI_IOC_SET_CS_POLARITY : {
+            retval = (int)cfgChnCsPolaritySet(
                 ctx,
-                &csDelay);
+                (enum xspiCsPolarity)arg);
 
-            if (NULL != usr) {
-                retval = rtdm_safe_copy_to_user(
-                    usr,
-                    arg,
-                    &csDelay,
-                    sizeof(int));
-            } else {
-                *(int *)arg = (int)csDelay;
-            }
+            break;
+        }
+
+/*-- XSPI_IOC_SET_CS_STATE ---------------------------------------------------*/
+        case XSPI_IOC_SET_CS_STATE : {
+            retval = (int)cfgChnCsStateSet(
+                ctx,
+                (enum xspiCsState)arg);
 
             break;
         }
 
-/*-- XSPI_IOC_SET_CS_POLARITY ------------------------------------------------*/
-        case XSPI_IOC_SET_CS_POLARITY : {
-            retval = (int)cfgChnCsPolaritySet(
+/*-- XSPI_IOC_CLAIM_CHN ------------------------------------------------------*/
+        case XSPI_IOC_CLAIM_CHN : {
+            retval = (int)cfgChnClaim(
                 ctx,
-                (enum xspiCsPolarity)arg);
+                (enum xspiChn)arg);
 
             break;
         }
 
-/*-- XSPI_IOC_GET_CS_POLARITY ------------------------------------------------*/
-        case XSPI_IOC_GET_CS_POLARITY : {
-            enum xspiCsPolarity csPolarity;
+/*-- XSPI_IOC_RELEASE_CHN ----------------------------------------------------*/
+        case XSPI_IOC_RELEASE_CHN : {
+            retval = (int)cfgChnRelease(
+                ctx,
+                (enum xspiChn)arg);
 
-            cfgChnCsPolarityGet(
+            break;
+        }
+
+/*-- XSPI_IOC_SET_CLOCK_FREQ -------------------------------------------------*/
+        case XSPI_IOC_SET_CLOCK_FREQ : {
+            retval = (int)cfgChnClockFreqSet(
                 ctx,
-                &csPolarity);
+                (uint32_t)arg);
 
-            if (NULL != usr) {
-                retval = rtdm_safe_copy_to_user(
-                    usr,
-                    arg,
-                    &csPolarity,
-                    sizeof(int));
-            } else {
-                *(int *)arg = (int)csPolarity;
-            }
+            break;
+        }
+
+/*-- XSPI_IOC_SAVE_PROFILE ---------------------------------------------------*/
+        case XSPI_IOC_SAVE_PROFILE : {
+            retval = (int)cfgChnProfileSave(
+                ctx,
+                (uint32_t)arg);
 
             break;
         }
 
-/*-- XSPI_IOC_SET_CS_STATE ---------------------------------------------------*/
-        case XSPI_IOC_SET_CS_STATE : {
-            retval = (int)cfgChnCsStateSet(
+/*-- XSPI_IOC_LOAD_PROFILE ---------------------------------------------------*/
+        case XSPI_IOC_LOAD_PROFILE : {
+            retval = (int)cfgChnProfileLoad(
                 ctx,
-                (enum xspiCsState)arg);
+                (uint32_t)arg);
 
             break;
         }
 
-/*-- XSPI_IOC_GET_CS_STATE ---------------------------------------------------*/
-        case XSPI_IOC_GET_CS_STATE : {
-            enum xspiCsState csState;
+/*-- XSPI_IOC_SET_JOB_WEIGHT -------------------------------------------------*/
+        case XSPI_IOC_SET_JOB_WEIGHT : {
+            retval = (int)cfgChnJobWeightSet(
+                ctx,
+                (uint32_t)arg);
 
-            cfgChnCsStateGet(
+            break;
+        }
+
+/*-- XSPI_IOC_SET_XFER_LEVEL -------------------------------------------------*/
+        case XSPI_IOC_SET_XFER_LEVEL : {
+            retval = (int)cfgChnXferLevelSet(
                 ctx,
-                &csState);
+                (uint32_t)arg);
 
-            if (NULL != usr) {
-                retval = rtdm_safe_copy_to_user(
-                    usr,
-                    arg,
-                    &csState,
-                    sizeof(int));
-            } else {
-                *(int *)arg = (int)csState;
-            }
+            break;
+        }
+
+/*-- XSPI_IOC_SET_PACKING ----------------------------------------------------*/
+        case XSPI_IOC_SET_PACKING : {
+            retval = (int)cfgChnPackingSet(
+                ctx,
+                (enum xspiPacking)arg);
 
             break;
         }
 
-/*-- XSPI_IOC_SET_CLOCK_FREQ -------------------------------------------------*/
-        case XSPI_IOC_SET_CLOCK_FREQ : {
+/*-- Not a channel request ---------------------------------------------------*/
+        default : {
+            retval = -ENOTTY;
+        }
+    }
+
+    return ((int32_t)retval);
+}
 
+/*
+ * Rest
+ */
+
+/* NOTE: Acquisition and streaming started by a descriptor end with it, they
+ *       would otherwise keep the channel configuration locked for all users.
+ */
+static void fdActvStop(
+    struct rtdm_dev_context * ctx) {
+
+    struct devCtx *     devCtx;
+    uint32_t            i;
+    int32_t             ret;
+
+    devCtx = getDevCtx(
+        ctx);
+    ret = busGet(
+        devCtx);
+
+    if (0 != ret) {
+        LOG_ERR("failed to claim the bus on close, err: %d", -ret);
+
+        return;
+    }
+
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
+
+        if ((TRUE == cyclicIsRunning(devCtx, i)) && (getFdCtx(ctx) == devCtx->chn[i].cyclic.owner)) {
+            (void)cyclicStop(
+                devCtx,
+                getFdCtx(ctx),
+                i);
+        }
+    }
+
+    if ((TRUE == devCtx->slave.running) && (getFdCtx(ctx) == devCtx->slave.owner)) {
+        (void)xferSlaveStop(
+            devCtx,
+            getFdCtx(ctx),
+            devCtx->slave.chn);
+    }
+    busPut(
+        devCtx);
+}
+
+static int handleOpen(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr,
+    int                 oflag) {
+
+    struct fdCtx *      fdCtx;
+    struct devCtx *     devCtx;
+    uint32_t            id;
+    int                 retval;
+
+    id = getDevId(
+        ctx->device);
+
+    if (CFG_MAX_DEVICES == id) {
+
+        return (-ENODEV);
+    }
+    retval = 0;
+    fdCtx = getFdCtx(
+        ctx);
+    fdCtx->chn = XSPI_CHN_0;
+    fdCtx->ring = NULL;
+    mutex_lock(
+        &DevCtxsLock);
+    devCtx = DevCtxs[id];
+
+    if (NULL != devCtx) {
+        fdCtx->devCtx = devCtx;
+        devCtx->users++;
+        jobFdInit(
+            fdCtx);
+        mutex_unlock(
+            &DevCtxsLock);
+
+        return (retval);
+    }
+    devCtx = kzalloc(
+        sizeof(struct devCtx),
+        GFP_KERNEL);
+
+    if (NULL == devCtx) {
+        mutex_unlock(
+            &DevCtxsLock);
+
+        return (-ENOMEM);
+    }
+    fdCtx->devCtx = devCtx;
+    retval = (int)ctxInit(
+        ctx);
+
+    if (0 == retval) {
+        retval = (int)cfgApply(
+            ctx);
+
+        if (0 == retval) {
+            retval = (int)xferInit(
+                ctx->device,
+                devCtx);
+        }
+
+        if (0 != retval) {
+            ctxTerm(
+                ctx);
         }
+    }
+
+    if (0 == retval) {
+        jobInit(
+            devCtx);
+        cyclicInit(
+            devCtx);
+        jobFdInit(
+            fdCtx);
+        devCtx->users = 1u;
+        DevCtxs[id] = devCtx;
+    } else {
+        kfree(
+            devCtx);
+    }
+    mutex_unlock(
+        &DevCtxsLock);
+
+    return (retval);
+}
+
+static int handleClose(
+    struct rtdm_dev_context * ctx,
+    rtdm_user_info_t *  usr) {
+
+    rtdm_lockctx_t      lockCtx;
+    struct devCtx *     devCtx;
+    uint32_t            i;
+    int                 retval;
 
-/*-- XSPI_IOC_GET_CLOCK_FREQ -------------------------------------------------*/
-        case XSPI_IOC_GET_CLOCK_FREQ : {
+    retval = 0;
+    devCtx = getDevCtx(
+        ctx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
 
-        }
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
 
-/*-- Unhandled request -------------------------------------------------------*/
-        default : {
-            LOG_DBG("IOC: unknown request (%d) received", req);
-            retval = -EINVAL;
+        if (getFdCtx(ctx) == devCtx->chn[i].owner) {
+            devCtx->chn[i].owner = NULL;
         }
     }
-
-    if (0 != retval) {
-        LOG_INFO("IOC: failed to execute IO request, err: %d", -retval);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    fdActvStop(
+        ctx);
+    jobFdTerm(
+        devCtx,
+        getFdCtx(ctx));
+    ringTerm(
+        getFdCtx(ctx));
+    mutex_lock(
+        &DevCtxsLock);
+    devCtx->users--;
+
+    if (0u == devCtx->users) {
+        cyclicTerm(
+            devCtx);
+        xferTerm(
+            devCtx);
+        jobTerm(
+            devCtx);
+        ctxTerm(
+            ctx);
+        DevCtxs[getDevId(ctx->device)] = NULL;
+        kfree(
+            devCtx);
     }
-
-/*-- Reset activity: enable communication ------------------------------------*/
-    rtdm_sem_up(
-        &devCtx->actvLock);
+    mutex_unlock(
+        &DevCtxsLock);
 
     return (retval);
 }
 
-static ssize_t handleRd(
+static int handleIOctl(
     struct rtdm_dev_context * ctx,
     rtdm_user_info_t *  usr,
-    void *              dst,
-    size_t              bytes) {
+    unsigned int        req,
+    void __user *       arg) {
 
-    rtdm_lockctx_t      lockCtx;
     struct devCtx *     devCtx;
-    ssize_t             read;
+    int                 retval;
 
-    read = 0;
     devCtx = getDevCtx(
         ctx);
+    retval = (int)getIOctl(
+        ctx,
+        usr,
+        req,
+        arg);
 
-/*-- Set activity: disable configuration -------------------------------------*/
-    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
-    devCtx->actvCnt++;
+    if (-ENOTTY != retval) {
 
-    if (1u == devCtx->actvCnt) {
-        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
-        rtdm_sem_down(
-            &devCtx->actvLock);
-    } else {
-        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        return (retval);
     }
+    retval = (int)chnIOctl(
+        ctx,
+        usr,
+        req,
+        arg);
 
-/*-- Reset activity: enable configuration ------------------------------------*/
-    devCtx->actvCnt--;
+    if (-ENOTTY != retval) {
+
+        if (0 > retval) {
+            LOG_INFO("IOC: failed to execute IO request, err: %d", -retval);
+        }
 
-    if (0u == devCtx->actvCnt) {
-        rtdm_sem_up(
-            &devCtx->actvLock);
+        return (retval);
     }
+    retval = 0;
 
-    return (read);
-}
+    if ((XSPI_IOC_JOB_SUBMIT == req) || (XSPI_IOC_JOB_REAP == req)) {
 
-static ssize_t handleWr(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    const void *        src,
-    size_t              bytes) {
+        retval = (int)jobIOctl(
+            ctx,
+            usr,
+            req,
+            arg);
 
-    rtdm_lockctx_t      lockCtx;
-    struct devCtx *     devCtx;
-    ssize_t             write;
+        return (retval);
+    }
 
-    write = 0;
-    devCtx = getDevCtx(
-        ctx);
+/*-- XSPI_IOC_TRANSFER -------------------------------------------------------*/
+    if (XSPI_IOC_TRANSFER == req) {
+        struct xspiTransfer transfer;
+        ssize_t         done;
 
-/*-- Set activity: disable configuration -------------------------------------*/
-    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
-    devCtx->actvCnt++;
+        retval = usrCopyFrom(
+            usr,
+            &transfer,
+            arg,
+            sizeof(transfer));
 
-    if (1u == devCtx->actvCnt) {
-        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
-        rtdm_sem_down(
-            &devCtx->actvLock);
-    } else {
-        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        if (0 != retval) {
+
+            return (retval);
+        }
+        done = chnXfer(
+            ctx,
+            usr,
+            transfer.tx,
+            transfer.rx,
+            transfer.length,
+            TRUE,
+            NULL,
+            NULL);
+
+        if (0 > done) {
+            retval = (int)done;
+        } else if ((size_t)done != transfer.length) {
+            retval = -EIO;
+        }
+
+        return (retval);
     }
 
-/*-- Reset activity: enable configuration ------------------------------------*/
-    devCtx->actvCnt--;
+/*-- XSPI_IOC_TRANSFER_TS ----------------------------------------------------*/
+    if (XSPI_IOC_TRANSFER_TS == req) {
+        struct xspiTransferTs transfer;
+        nanosecs_abs_t  timeStart;
+        nanosecs_abs_t  timeEnd;
+        ssize_t         done;
+
+        retval = usrCopyFrom(
+            usr,
+            &transfer,
+            arg,
+            sizeof(transfer));
+
+        if (0 != retval) {
+
+            return (retval);
+        }
+        done = chnXfer(
+            ctx,
+            usr,
+            transfer.transfer.tx,
+            transfer.transfer.rx,
+            transfer.transfer.length,
+            TRUE,
+            &timeStart,
+            &timeEnd);
+
+        if (0 > done) {
+            retval = (int)done;
+        } else if ((size_t)done != transfer.transfer.length) {
+            retval = -EIO;
+        } else {
+            transfer.timeStart = (uint64_t)timeStart;
+            transfer.timeEnd = (uint64_t)timeEnd;
+            retval = usrCopyTo(
+                usr,
+                arg,
+                &transfer,
+                sizeof(transfer));
+        }
 
-    if (0u == devCtx->actvCnt) {
-        rtdm_sem_up(
-            &devCtx->actvLock);
+        return (retval);
     }
 
-    return (write);
-}
+/*-- Set activity: disable communication -------------------------------------*/
+    retval = (int)busGet(
+        devCtx);
 
-/******************************************************************************
- * DMA MODE 1
- ******************************************************************************/
-#elif (1u == CFG_DMA_MODE)
+    if (0 != retval) {
 
-static int handleOpen(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    int                 oflag) {
+        return (retval);
+    }
 
-    int                 retval;
+    switch (req) {
+/*-- XSPI_IOC_SET_FIFO_MODE --------------------------------------------------*/
+        case XSPI_IOC_SET_FIFO_CHN : {
+            retval = (int)cfgFIFOChnSet(
+                ctx,
+                (enum xspiFifoChn)arg);
 
-    retval = 0;
+            break;
+        }
 
-    return (retval);
-}
+/*-- XSPI_IOC_SET_CS_MODE ----------------------------------------------------*/
+        case XSPI_IOC_SET_CS_MODE : {
+            retval = (int)cfgCsModeSet(
+                ctx,
+                (enum xspiCsMode)arg);
 
-static int handleClose(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr) {
+            break;
+        }
 
-    int                 retval;
+/*-- XSPI_IOC_SET_MODE -------------------------------------------------------*/
+        case XSPI_IOC_SET_MODE : {
+            retval = (int)cfgModeSet(
+                ctx,
+                (enum xspiMode)arg);
 
-    retval = 0;
+            break;
+        }
 
-    return (retval);
-}
+/*-- XSPI_IOC_SET_CHANNEL_MODE -----------------------------------------------*/
+        case XSPI_IOC_SET_CHANNEL_MODE : {
+            retval = (int)cfgChannelModeSet(
+                ctx,
+                (enum xspiChannelMode)arg);
 
-static int handleIOctl(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    unsigned int        req,
-    void __user *       arg) {
+            break;
+        }
 
-    int                 retval;
+/*-- XSPI_IOC_SET_INITIAL_DELAY ----------------------------------------------*/
+        case XSPI_IOC_SET_INITIAL_DELAY : {
+            retval = (int)cfgInitialDelaySet(
+                ctx,
+                (enum xspiInitialDelay)arg);
 
-    retval = 0;
+            break;
+        }
 
-    return (retval);
-}
+/*-- XSPI_IOC_SET_PIO_THRESHOLD ----------------------------------------------*/
+        case XSPI_IOC_SET_PIO_THRESHOLD : {
+            retval = (int)cfgPioThresholdSet(
+                ctx,
+                (uint32_t)arg);
 
-static ssize_t handleRd(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    void *              dst,
-    size_t              bytes) {
+            break;
+        }
 
-    ssize_t             read;
+/*-- XSPI_IOC_MESSAGE --------------------------------------------------------*/
+        case XSPI_IOC_MESSAGE : {
+            struct xspiMessage msg;
 
-    read = 0;
+            retval = usrCopyFrom(
+                usr,
+                &msg,
+                arg,
+                sizeof(msg));
 
-    return (read);
-}
+            if (0 == retval) {
+                retval = (int)chnMessage(
+                    ctx,
+                    usr,
+                    &msg);
+            }
 
-static ssize_t handleWr(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    const void *        src,
-    size_t              bytes) {
+            break;
+        }
 
-    ssize_t             write;
+/*-- XSPI_IOC_RING_MAP -------------------------------------------------------*/
+        case XSPI_IOC_RING_MAP : {
+            struct xspiRingMap map;
 
-    write = 0;
+            retval = usrCopyFrom(
+                usr,
+                &map,
+                arg,
+                sizeof(map));
 
-    return (write);
-}
+            if (0 == retval) {
+                retval = (int)ringMap(
+                    getFdCtx(ctx),
+                    usr,
+                    &map);
+            }
 
-#elif (2u == CFG_DMA_MODE)
+            if (0 == retval) {
+                retval = usrCopyTo(
+                    usr,
+                    arg,
+                    &map,
+                    sizeof(map));
+            }
 
-static int handleOpen(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    int                 oflag) {
+            break;
+        }
 
-    int                 retval;
+/*-- XSPI_IOC_RING_KICK ------------------------------------------------------*/
+        case XSPI_IOC_RING_KICK : {
+            enum xspiChn chn;
 
-    retval = 0;
+            chn = getChn(ctx);
+            retval = (int)chnActvGet(
+                ctx,
+                chn);
 
-    return (retval);
-}
+            if (0 != retval) {
 
-static int handleClose(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr) {
+                break;
+            }
+            retval = (int)ringKick(
+                ctx->device,
+                devCtx,
+                getFdCtx(ctx),
+                chn);
+            chnActvPut(
+                ctx,
+                chn);
 
-    int                 retval;
+            break;
+        }
 
-    retval = 0;
+/*-- XSPI_IOC_CYCLIC_START ---------------------------------------------------*/
+        case XSPI_IOC_CYCLIC_START : {
+            struct xspiCyclic cyclic;
+            enum xspiChn chn;
 
-    return (retval);
-}
+            chn = getChn(ctx);
+            retval = usrCopyFrom(
+                usr,
+                &cyclic,
+                arg,
+                sizeof(cyclic));
+
+            if (0 == retval) {
+                retval = (int)chnActvGet(
+                    ctx,
+                    chn);
+            }
 
-static int handleIOctl(
-    struct rtdm_dev_context * ctx,
-    rtdm_user_info_t *  usr,
-    unsigned int        req,
-    void __user *       arg) {
+            if (0 != retval) {
 
-    int                 retval;
+                break;
+            }
+            retval = (int)cyclicStart(
+                devCtx,
+                getFdCtx(ctx),
+                chn,
+                &cyclic);
+            chnActvPut(
+                ctx,
+                chn);
 
-    retval = 0;
+            break;
+        }
+
+/*-- XSPI_IOC_CYCLIC_STOP ----------------------------------------------------*/
+        case XSPI_IOC_CYCLIC_STOP : {
+            enum xspiChn chn;
+
+            chn = getChn(ctx);
+            retval = (int)chnActvGet(
+                ctx,
+                chn);
+
+            if (0 != retval) {
+
+                break;
+            }
+            retval = (int)cyclicStop(
+                devCtx,
+                getFdCtx(ctx),
+                chn);
+            chnActvPut(
+                ctx,
+                chn);
+
+            break;
+        }
+
+/*-- XSPI_IOC_SLAVE_START ----------------------------------------------------*/
+        case XSPI_IOC_SLAVE_START : {
+            enum xspiChn chn;
+
+            chn = getChn(ctx);
+            retval = (int)chnActvGet(
+                ctx,
+                chn);
+
+            if (0 != retval) {
+
+                break;
+            }
+            retval = (int)xferSlaveStart(
+                devCtx,
+                getFdCtx(ctx),
+                chn,
+                (uint32_t)arg);
+            chnActvPut(
+                ctx,
+                chn);
+
+            break;
+        }
+
+/*-- XSPI_IOC_SLAVE_STOP -----------------------------------------------------*/
+        case XSPI_IOC_SLAVE_STOP : {
+            enum xspiChn chn;
+
+            chn = getChn(ctx);
+            retval = (int)chnActvGet(
+                ctx,
+                chn);
+
+            if (0 != retval) {
+
+                break;
+            }
+            retval = (int)xferSlaveStop(
+                devCtx,
+                getFdCtx(ctx),
+                chn);
+            chnActvPut(
+                ctx,
+                chn);
+
+            break;
+        }
+
+/*-- Unhandled request -------------------------------------------------------*/
+        default : {
+            LOG_DBG("IOC: unknown request (%d) received", req);
+            retval = -EINVAL;
+        }
+    }
+
+    if (0 > retval) {
+        LOG_INFO("IOC: failed to execute IO request, err: %d", -retval);
+    }
+
+/*-- Reset activity: enable communication ------------------------------------*/
+    busPut(
+        devCtx);
 
     return (retval);
 }
@@ -1374,7 +3227,29 @@ static ssize_t handleRd(
 
     ssize_t             read;
 
-    read = 0;
+    if (TRUE == cyclicIsRunning(getDevCtx(ctx), getChn(ctx))) {
+        read = chnCyclicRead(
+            ctx,
+            usr,
+            dst,
+            bytes);
+    } else if (TRUE == xferSlaveIsRunning(getDevCtx(ctx), getChn(ctx))) {
+        read = chnSlaveRead(
+            ctx,
+            usr,
+            dst,
+            bytes);
+    } else {
+        read = chnXfer(
+            ctx,
+            usr,
+            NULL,
+            dst,
+            bytes,
+            TRUE,
+            NULL,
+            NULL);
+    }
 
     return (read);
 }
@@ -1387,13 +3262,19 @@ static ssize_t handleWr(
 
     ssize_t             write;
 
-    write = 0;
+    write = chnXfer(
+        ctx,
+        usr,
+        src,
+        NULL,
+        bytes,
+        TRUE,
+        NULL,
+        NULL);
 
     return (write);
 }
 
-#endif
-
 /*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
 /*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
 
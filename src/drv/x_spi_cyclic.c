@@ -0,0 +1,358 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Cyclic acquisition implementation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "drv/x_spi_cyclic.h"
+#include "drv/x_spi_xfer.h"
+#include "drv/x_spi_job.h"
+#include "drv/x_spi.h"
+#include "log/log.h"
+#include "dbg/dbg.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void cyclicHandler(
+    rtdm_timer_t *      timer);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO("x_spi_cyclic", "Cyclic acquisition", DEF_DRV_AUTHOR);
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+/* NOTE: Called from timer interrupt context. The transaction never waits, a
+ *       period is skipped when the bus is in use or the sample ring is full.
+ *       The bus is released as from interrupt context, so jobs queued in the
+ *       meantime continue to execute.
+ */
+static void cyclicHandler(
+    rtdm_timer_t *      timer) {
+
+    struct cyclicCtx *  cyclic;
+    struct devCtx *     devCtx;
+    struct xspiSample * sample;
+    struct xspiChnStatus * stat;
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            seq;
+    bool_T              bus;
+    bool_T              full;
+
+    cyclic = container_of(timer, struct cyclicCtx, timer);
+    devCtx = cyclic->devCtx;
+    stat = &devCtx->chn[cyclic->chn].stat;
+    bus = jobBusTryGet(
+        devCtx);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    seq = cyclic->seq++;
+    full = (CFG_CYCLIC_DEPTH <= (cyclic->head - cyclic->tail)) ? TRUE : FALSE;
+
+    if ((FALSE == cyclic->running) || (FALSE == bus) || (TRUE == full)) {
+
+        if (TRUE == cyclic->running) {
+            write_seqcount_begin(
+                &devCtx->statSeq);
+
+            if (FALSE == bus) {
+                stat->cyclicBusy++;
+            } else {
+                stat->cyclicOverruns++;
+            }
+            write_seqcount_end(
+                &devCtx->statSeq);
+        }
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        if (TRUE == bus) {
+            jobBusPutIrq(
+                devCtx);
+        }
+
+        return;
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    sample = &cyclic->sample[cyclic->head % CFG_CYCLIC_DEPTH];
+    sample->time = rtdm_clock_read_monotonic();
+    sample->seq = seq;
+    sample->status = xferPoll(
+        devCtx,
+        cyclic->chn,
+        cyclic->desc.tx,
+        cyclic->rx,
+        cyclic->desc.length);
+    memcpy(
+        sample->rx,
+        &cyclic->rx[cyclic->desc.offset],
+        cyclic->desc.length - cyclic->desc.offset);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    cyclic->head++;
+    write_seqcount_begin(
+        &devCtx->statSeq);
+    stat->cyclicSamples++;
+    write_seqcount_end(
+        &devCtx->statSeq);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    rtdm_event_signal(
+        &cyclic->ready);
+    jobBusPutIrq(
+        devCtx);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+void cyclicInit(
+    struct devCtx *     devCtx) {
+
+    uint32_t            i;
+
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
+        struct cyclicCtx * cyclic;
+
+        cyclic = &devCtx->chn[i].cyclic;
+        cyclic->devCtx  = devCtx;
+        cyclic->chn     = i;
+        cyclic->running = FALSE;
+        cyclic->head    = 0u;
+        cyclic->tail    = 0u;
+        rtdm_event_init(
+            &cyclic->ready,
+            0ul);
+        (void)rtdm_timer_init(
+            &cyclic->timer,
+            cyclicHandler,
+            "xspi cyclic");
+    }
+}
+
+void cyclicTerm(
+    struct devCtx *     devCtx) {
+
+    uint32_t            i;
+
+    for (i = 0u; i < DEF_CHN_COUNT; i++) {
+        rtdm_timer_destroy(
+            &devCtx->chn[i].cyclic.timer);
+        rtdm_event_destroy(
+            &devCtx->chn[i].cyclic.ready);
+    }
+}
+
+int32_t cyclicStart(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    const struct xspiCyclic * desc) {
+
+    struct cyclicCtx *  cyclic;
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            wordSize;
+    int32_t             ret;
+
+    LOG_DBG("start on channel %d, period %llu ns", chn, desc->period);
+
+    if ((DEF_CHN_COUNT <= chn) || (TRUE != devCtx->chn[chn].online)) {
+
+        return (-EINVAL);
+    }
+    wordSize = xferWordSize(
+        devCtx->chn[chn].cfg.wordLength);
+
+    if ((CFG_CYCLIC_PERIOD_MIN_NS > desc->period) ||
+        (0u == desc->length) ||
+        (XSPI_CYCLIC_DATA_MAX < desc->length) ||
+        (desc->length <= desc->offset) ||
+        (0u != (desc->length % wordSize)) ||
+        (0u != (desc->offset % wordSize))) {
+
+        return (-EINVAL);
+    }
+    cyclic = &devCtx->chn[chn].cyclic;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (TRUE == cyclic->running) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EBUSY);
+    }
+    cyclic->desc = *desc;
+    cyclic->owner = fdCtx;
+    cyclic->seq = 0u;
+    cyclic->head = 0u;
+    cyclic->tail = 0u;
+    cyclic->running = TRUE;
+    devCtx->chn[chn].actvCnt++;                                                 /* Channel configuration is locked while acquisition runs   */
+    rtdm_event_clear(
+        &cyclic->ready);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    ret = rtdm_timer_start(
+        &cyclic->timer,
+        (nanosecs_abs_t)desc->period,
+        (nanosecs_rel_t)desc->period,
+        RTDM_TIMERMODE_RELATIVE);
+
+    if (0 != ret) {
+        LOG_ERR("failed to start acquisition timer, err: %d", -ret);
+        rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+        cyclic->running = FALSE;
+        devCtx->chn[chn].actvCnt--;
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    }
+
+    return (ret);
+}
+
+int32_t cyclicStop(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn) {
+
+    struct cyclicCtx *  cyclic;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("stop on channel %d", chn);
+
+    if (DEF_CHN_COUNT <= chn) {
+
+        return (-EINVAL);
+    }
+    cyclic = &devCtx->chn[chn].cyclic;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == cyclic->running) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EINVAL);
+    }
+
+    if (fdCtx != cyclic->owner) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+    cyclic->running = FALSE;
+    cyclic->tail = cyclic->head;                                                /* Discard samples not read yet                             */
+    devCtx->chn[chn].actvCnt--;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    rtdm_timer_stop(
+        &cyclic->timer);
+    rtdm_event_signal(                                                          /* Wake up the reader                                       */
+        &cyclic->ready);
+
+    return (0);
+}
+
+bool_T cyclicIsRunning(
+    struct devCtx *     devCtx,
+    uint32_t            chn) {
+
+    return (devCtx->chn[chn].cyclic.running);
+}
+
+/* NOTE: The timer handler never stores into a sample between tail and head,
+ *       so samples returned here are copied without holding the lock. Owner
+ *       is checked again after each wait, acquisition may have been restarted
+ *       by another descriptor meanwhile.
+ */
+int32_t cyclicPeek(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    nanosecs_rel_t      timeout,
+    const struct xspiSample ** samples,
+    size_t *            count) {
+
+    struct cyclicCtx *  cyclic;
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            slot;
+    int32_t             ret;
+
+    cyclic = &devCtx->chn[chn].cyclic;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    while ((fdCtx == cyclic->owner) && (cyclic->head == cyclic->tail) && (TRUE == cyclic->running)) {
+
+        if (0 > timeout) {
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+            return (-EWOULDBLOCK);
+        }
+        rtdm_event_clear(
+            &cyclic->ready);
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        ret = rtdm_event_timedwait(
+            &cyclic->ready,
+            timeout,
+            NULL);
+
+        if (0 != ret) {
+
+            return (ret);
+        }
+        rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    }
+
+    if (fdCtx != cyclic->owner) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+    slot = cyclic->tail % CFG_CYCLIC_DEPTH;
+    *samples = &cyclic->sample[slot];
+    *count = min_t(size_t, cyclic->head - cyclic->tail, CFG_CYCLIC_DEPTH - slot);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+void cyclicConsume(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    size_t              count) {
+
+    struct cyclicCtx *  cyclic;
+    rtdm_lockctx_t      lockCtx;
+
+    cyclic = &devCtx->chn[chn].cyclic;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (fdCtx == cyclic->owner) {                                               /* Acquisition may have been restarted by other fd          */
+        count = min_t(size_t, count, cyclic->head - cyclic->tail);              /* Acquisition may have been stopped in the meantime        */
+        cyclic->tail += (uint32_t)count;
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_cyclic.c
+ ******************************************************************************/
@@ -0,0 +1,510 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Job queues implementation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "drv/x_spi_job.h"
+#include "drv/x_spi_xfer.h"
+#include "drv/x_spi_pack.h"
+#include "drv/x_spi.h"
+#include "log/log.h"
+#include "dbg/dbg.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+/**@brief       Longest time a synchronous caller waits for the bus
+ */
+#define JOB_BUS_TIMEOUT_NS              (CFG_XFER_TIMEOUT_NS * ((DEF_CHN_COUNT * CFG_JOB_QUEUE_DEPTH) + 1u))
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static struct jobCtx * jobNext(
+    struct devCtx *     devCtx);
+
+static void jobTrim(
+    struct chnQueue *   queue);
+
+static void jobFinish(
+    struct devCtx *     devCtx,
+    int32_t             status);
+
+static void jobComplete(
+    struct devCtx *     devCtx,
+    int32_t             status);
+
+static void jobRun(
+    struct devCtx *     devCtx);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO("x_spi_job", "Job queues", DEF_DRV_AUTHOR);
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+/* NOTE: Must be called with device lock held. Channels are served in
+ *       round-robin order, a channel gets up to jobWeight jobs in one round
+ *       before the scheduler moves to the next channel with queued jobs.
+ */
+static struct jobCtx * jobNext(
+    struct devCtx *     devCtx) {
+
+    struct jobQueue *   jobs;
+    uint32_t            cnt;
+
+    jobs = &devCtx->jobs;
+
+    for (cnt = 0u; cnt <= DEF_CHN_COUNT; cnt++) {
+        struct chnQueue * queue;
+
+        queue = &devCtx->chn[jobs->chn].queue;
+
+        if ((0u != jobs->credit) && (queue->exec != queue->head)) {
+            jobs->credit--;
+
+            return (&queue->job[queue->exec % CFG_JOB_QUEUE_DEPTH]);
+        }
+        jobs->chn = (jobs->chn + 1u) % DEF_CHN_COUNT;
+        jobs->credit = devCtx->chn[jobs->chn].cfg.jobWeight;
+    }
+
+    return (NULL);
+}
+
+/* NOTE: Must be called with device lock held. Descriptors reap their jobs
+ *       out of order, a slot is reused only when all older slots of the
+ *       channel are reaped too.
+ */
+static void jobTrim(
+    struct chnQueue *   queue) {
+
+    while ((queue->tail != queue->exec) &&
+           (TRUE == queue->job[queue->tail % CFG_JOB_QUEUE_DEPTH].reaped)) {
+        queue->tail++;
+    }
+}
+
+/* NOTE: The job being finished is always the oldest not executed job of the
+ *       channel currently served by the scheduler. Completion is posted to the
+ *       submitting descriptor under the device lock, so the descriptor can't
+ *       be closed in the meantime. Jobs of a closed descriptor are dropped.
+ */
+static void jobFinish(
+    struct devCtx *     devCtx,
+    int32_t             status) {
+
+    struct jobQueue *   jobs;
+    struct chnQueue *   queue;
+    struct jobCtx *     job;
+    rtdm_lockctx_t      lockCtx;
+
+    jobs = &devCtx->jobs;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    queue = &devCtx->chn[jobs->chn].queue;
+    job = &queue->job[queue->exec % CFG_JOB_QUEUE_DEPTH];
+    job->status = status;
+    queue->exec++;
+    devCtx->chn[jobs->chn].actvCnt--;
+
+    if (NULL != job->owner) {
+        struct jobCpl * cpl;
+
+        cpl = &job->owner->cpl;
+        cpl->job[cpl->head % ARRAY_SIZE(cpl->job)] = job;
+        cpl->head++;
+        rtdm_sem_up(
+            &cpl->done);
+    } else {
+        job->reaped = TRUE;
+        jobTrim(
+            queue);
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+}
+
+static void jobComplete(
+    struct devCtx *     devCtx,
+    int32_t             status) {
+
+    jobFinish(
+        devCtx,
+        status);
+    jobRun(
+        devCtx);
+}
+
+/* NOTE: Called with the bus claimed. Jobs are executed until one of them is
+ *       started asynchronously, its completion continues the execution. When
+ *       the queue is empty the bus is released. A job which can't be started
+ *       completes at once with the error.
+ */
+static void jobRun(
+    struct devCtx *     devCtx) {
+
+    struct jobQueue *   jobs;
+    rtdm_lockctx_t      lockCtx;
+
+    jobs = &devCtx->jobs;
+
+    for (;;) {
+        struct jobCtx * job;
+        uint32_t        chn;
+        int32_t         ret;
+
+        rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+        job = jobNext(
+            devCtx);
+
+        if (NULL == job) {
+            jobs->busy = FALSE;
+            rtdm_event_signal(
+                &jobs->idle);
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+            return;
+        }
+        chn = jobs->chn;
+        devCtx->chn[chn].actvCnt++;                                             /* Channel configuration is locked while the job runs       */
+
+        if (NULL == job->owner) {                                               /* Submitting descriptor was closed                         */
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+            jobFinish(
+                devCtx,
+                -ECANCELED);
+
+            continue;
+        }
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        ret = xferStart(
+            devCtx->xfer.dev,
+            devCtx,
+            chn,
+            (NULL != job->desc.tx) ? job->tx : NULL,
+            (NULL != job->desc.rx) ? job->rx : NULL,
+            job->length,
+            jobComplete);
+
+        if (0 == ret) {
+
+            return;
+        }
+        LOG_DBG("job on channel %d not started, err: %d", chn, -ret);
+        jobFinish(
+            devCtx,
+            ret);
+    }
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+void jobInit(
+    struct devCtx *     devCtx) {
+
+    struct jobQueue *   jobs;
+    uint32_t            chn;
+
+    jobs = &devCtx->jobs;
+
+    for (chn = 0u; chn < DEF_CHN_COUNT; chn++) {
+        devCtx->chn[chn].queue.head = 0u;
+        devCtx->chn[chn].queue.exec = 0u;
+        devCtx->chn[chn].queue.tail = 0u;
+    }
+    jobs->chn = 0u;
+    jobs->credit = devCtx->chn[0].cfg.jobWeight;
+    jobs->busy = FALSE;
+    rtdm_event_init(
+        &jobs->idle,
+        0ul);
+}
+
+void jobTerm(
+    struct devCtx *     devCtx) {
+
+    rtdm_event_destroy(
+        &devCtx->jobs.idle);
+}
+
+void jobFdInit(
+    struct fdCtx *      fdCtx) {
+
+    fdCtx->cpl.head = 0u;
+    fdCtx->cpl.tail = 0u;
+    rtdm_sem_init(
+        &fdCtx->cpl.done,
+        0ul);
+}
+
+/* NOTE: Jobs of the descriptor which are not executed yet are cancelled when
+ *       the scheduler reaches them and a running job completes normally,
+ *       neither is posted. Executed jobs not reaped yet are released at once.
+ */
+void jobFdTerm(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx) {
+
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            chn;
+
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    for (chn = 0u; chn < DEF_CHN_COUNT; chn++) {
+        struct chnQueue * queue;
+        uint32_t        slot;
+
+        queue = &devCtx->chn[chn].queue;
+
+        for (slot = queue->tail; slot != queue->head; slot++) {
+            struct jobCtx * job;
+
+            job = &queue->job[slot % CFG_JOB_QUEUE_DEPTH];
+
+            if (fdCtx == job->owner) {
+                job->owner = NULL;
+
+                if ((slot - queue->tail) < (queue->exec - queue->tail)) {       /* Already executed, waits to be reaped                     */
+                    job->reaped = TRUE;
+                }
+            }
+        }
+        jobTrim(
+            queue);
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    rtdm_sem_destroy(
+        &fdCtx->cpl.done);
+}
+
+int32_t jobBusGet(
+    struct devCtx *     devCtx) {
+
+    struct jobQueue *   jobs;
+    rtdm_lockctx_t      lockCtx;
+    int32_t             ret;
+
+    jobs = &devCtx->jobs;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    while (TRUE == jobs->busy) {
+        rtdm_event_clear(
+            &jobs->idle);
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        ret = rtdm_event_timedwait(
+            &jobs->idle,
+            JOB_BUS_TIMEOUT_NS,
+            NULL);
+
+        if (0 != ret) {
+            LOG_DBG("failed to claim the bus, err: %d", -ret);
+
+            return (ret);
+        }
+        rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    }
+    jobs->busy = TRUE;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+void jobBusPut(
+    struct devCtx *     devCtx) {
+
+    jobRun(
+        devCtx);
+}
+
+bool_T jobBusTryGet(
+    struct devCtx *     devCtx) {
+
+    rtdm_lockctx_t      lockCtx;
+    bool_T              ret;
+
+    ret = FALSE;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (FALSE == devCtx->jobs.busy) {
+        devCtx->jobs.busy = TRUE;
+        ret = TRUE;
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (ret);
+}
+
+void jobBusPutIrq(
+    struct devCtx *     devCtx) {
+
+    jobRun(
+        devCtx);
+}
+
+int32_t jobSubmit(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    const struct xspiJob * desc,
+    const void *        tx) {
+
+    struct jobQueue *   jobs;
+    struct chnQueue *   queue;
+    struct jobCtx *     job;
+    rtdm_lockctx_t      lockCtx;
+    size_t              words;
+    uint32_t            pack;
+    bool_T              start;
+
+    if ((0u == desc->length) || (CFG_JOB_BUFF_SIZE < desc->length)) {
+
+        return (-EINVAL);
+    }
+
+    if ((DEF_CHN_COUNT <= chn) || (TRUE != devCtx->chn[chn].online)) {
+
+        return (-EINVAL);
+    }
+
+    if ((XSPI_FIFO_CHN_DISABLED == devCtx->cfg.fifoChn) || (chn != (uint32_t)devCtx->cfg.fifoChn)) {
+
+        return (-EOPNOTSUPP);                                                   /* Only FIFO channel completes without a waiting caller     */
+    }
+    jobs = &devCtx->jobs;
+    queue = &devCtx->chn[chn].queue;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (CFG_JOB_QUEUE_DEPTH <= (queue->head - queue->tail)) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EAGAIN);
+    }
+    pack = 0u;
+    words = desc->length;
+
+    if (XSPI_PACKING_NONE != devCtx->chn[chn].cfg.packing) {
+        pack = devCtx->chn[chn].cfg.wordLength;
+
+        if ((0 != packWordsGet(desc->length, pack, &words)) ||
+            (CFG_JOB_BUFF_SIZE < (words * xferWordSize(pack)))) {
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+            return (-EINVAL);
+        }
+    }
+    job = &queue->job[queue->head % CFG_JOB_QUEUE_DEPTH];
+    job->desc = *desc;
+    job->owner = fdCtx;
+    job->chn = chn;
+    job->reaped = FALSE;
+    job->status = 0;
+    job->pack = pack;
+    job->length = (0u != pack) ? (words * xferWordSize(pack)) : desc->length;
+
+    if ((NULL != tx) && (0u != pack)) {
+        packUnpack(
+            job->tx,
+            tx,
+            words,
+            pack);
+    } else if (NULL != tx) {
+        memcpy(
+            job->tx,
+            tx,
+            desc->length);
+    }
+    queue->head++;
+    start = FALSE;
+
+    if (FALSE == jobs->busy) {
+        jobs->busy = TRUE;
+        start = TRUE;
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    if (TRUE == start) {
+        jobRun(
+            devCtx);
+    }
+
+    return (0);
+}
+
+int32_t jobReap(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    nanosecs_rel_t      timeout,
+    struct xspiJob *    desc,
+    int32_t *           status,
+    void *              rx) {
+
+    struct jobCpl *     cpl;
+    struct jobCtx *     job;
+    rtdm_lockctx_t      lockCtx;
+    int32_t             ret;
+
+    cpl = &fdCtx->cpl;
+    ret = rtdm_sem_timeddown(
+        &cpl->done,
+        timeout,
+        NULL);
+
+    if (0 != ret) {
+
+        return (ret);
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    job = cpl->job[cpl->tail % ARRAY_SIZE(cpl->job)];
+    cpl->tail++;
+    *desc = job->desc;
+    *status = job->status;
+
+    if ((NULL != job->desc.rx) && (0u != job->pack)) {
+        packPack(
+            rx,
+            job->rx,
+            job->length / xferWordSize(job->pack),
+            job->pack);
+    } else if (NULL != job->desc.rx) {
+        memcpy(
+            rx,
+            job->rx,
+            job->desc.length);
+    }
+    job->reaped = TRUE;
+    jobTrim(
+        &devCtx->chn[job->chn].queue);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_job.c
+ ******************************************************************************/
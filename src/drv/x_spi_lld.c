@@ -27,6 +27,7 @@
 /*=========================================================  INCLUDE FILES  ==*/
 
 #include "linux/io.h"
+#include "linux/cache.h"
 
 #include "port/port.h"
 #include "drv/x_spi_lld.h"
@@ -90,8 +91,8 @@
 #define MCSPI_CH_CONF_DMAR_Mask         (0x01u << MCSPI_CH_CONF_DMAR_Pos)
 #define MCSPI_CH_CONF_DMAW_Pos          (14u)
 #define MCSPI_CH_CONF_DMAW_Mask         (0x01u << MCSPI_CH_CONF_DMAW_Pos)
-#define MCSPI_CH_CONF_TRM_Pos           (13u)
-#define MCSPI_CH_CONF_TRM_Mask          (0x01u << MCSPI_CH_CONF_TRM_Pos)
+#define MCSPI_CH_CONF_TRM_Pos           (12u)
+#define MCSPI_CH_CONF_TRM_Mask          (0x03u << MCSPI_CH_CONF_TRM_Pos)
 #define MCSPI_CH_CONF_WL_Pos            (7u)
 #define MCSPI_CH_CONF_WL_Mask           (0x1fu << MCSPI_CH_CONF_WL_Pos)
 #define MCSPI_CH_CONF_EPOL_Pos          (6u)
@@ -103,6 +104,60 @@
 #define MCSPI_CH_CONF_PHA_Pos           (0u)
 #define MCSPI_CH_CONF_PHA_Mask          (0x01u << MCSPI_CH_CONF_PHA_Pos)
 
+#define MCSPI_CH_CONF_XFER_Mask                                                 \
+    (MCSPI_CH_CONF_FFER_Mask | MCSPI_CH_CONF_FFEW_Mask |                        \
+     MCSPI_CH_CONF_FORCE_Mask | MCSPI_CH_CONF_DMAR_Mask |                       \
+     MCSPI_CH_CONF_DMAW_Mask)
+
+#define MCSPI_CH_CONF_TRM_RX_ONLY       (0x01u << MCSPI_CH_CONF_TRM_Pos)
+#define MCSPI_CH_CONF_TRM_TX_ONLY       (0x02u << MCSPI_CH_CONF_TRM_Pos)
+
+#define MCSPI_CH_STAT_RXFFF_Pos         (6u)
+#define MCSPI_CH_STAT_RXFFF_Mask        (0x01u << MCSPI_CH_STAT_RXFFF_Pos)
+#define MCSPI_CH_STAT_RXFFE_Pos         (5u)
+#define MCSPI_CH_STAT_RXFFE_Mask        (0x01u << MCSPI_CH_STAT_RXFFE_Pos)
+#define MCSPI_CH_STAT_TXFFF_Pos         (4u)
+#define MCSPI_CH_STAT_TXFFF_Mask        (0x01u << MCSPI_CH_STAT_TXFFF_Pos)
+#define MCSPI_CH_STAT_TXFFE_Pos         (3u)
+#define MCSPI_CH_STAT_TXFFE_Mask        (0x01u << MCSPI_CH_STAT_TXFFE_Pos)
+#define MCSPI_CH_STAT_EOT_Pos           (2u)
+#define MCSPI_CH_STAT_EOT_Mask          (0x01u << MCSPI_CH_STAT_EOT_Pos)
+#define MCSPI_CH_STAT_TXS_Pos           (1u)
+#define MCSPI_CH_STAT_TXS_Mask          (0x01u << MCSPI_CH_STAT_TXS_Pos)
+#define MCSPI_CH_STAT_RXS_Pos           (0u)
+#define MCSPI_CH_STAT_RXS_Mask          (0x01u << MCSPI_CH_STAT_RXS_Pos)
+
+#define MCSPI_XFERLEVEL_WCNT_Pos        (16u)
+#define MCSPI_XFERLEVEL_WCNT_Mask       (0xffffu << MCSPI_XFERLEVEL_WCNT_Pos)
+#define MCSPI_XFERLEVEL_AFL_Pos         (8u)
+#define MCSPI_XFERLEVEL_AFL_Mask        (0x3fu << MCSPI_XFERLEVEL_AFL_Pos)
+#define MCSPI_XFERLEVEL_AEL_Pos         (0u)
+#define MCSPI_XFERLEVEL_AEL_Mask        (0x3fu << MCSPI_XFERLEVEL_AEL_Pos)
+
+#define MCSPI_CH_CTRL_EXTCLK_Pos        (8u)
+#define MCSPI_CH_CTRL_EXTCLK_Mask       (0xffu << MCSPI_CH_CTRL_EXTCLK_Pos)
+#define MCSPI_CH_CTRL_EN_Pos            (0u)
+#define MCSPI_CH_CTRL_EN_Mask           (0x01u << MCSPI_CH_CTRL_EN_Pos)
+
+/**@brief       Highest divider ratio with one clock cycle granularity
+ */
+#define MCSPI_CLK_FINE_RATIO_MAX        (4096u)
+
+/**@brief       Highest power of two divider ratio
+ */
+#define MCSPI_CLK_RATIO_MAX             (32768u)
+
+/*-- Shadow batch dirty bits -------------------------------------------------*/
+#define SHADOW_DIRTY_MODULCTRL          (0x01u << 0)
+#define SHADOW_DIRTY_XFERLEVEL          (0x01u << 1)
+#define SHADOW_DIRTY_IRQENABLE          (0x01u << 2)
+#define SHADOW_DIRTY_CH_CONF(chn)       (0x01u << (4u + (chn)))
+#define SHADOW_DIRTY_CH_CTRL(chn)       (0x01u << (8u + (chn)))
+
+/**@brief       Number of channels tracked by shadow batch
+ */
+#define SHADOW_CHN_COUNT                4u
+
 /*======================================================  LOCAL DATA TYPES  ==*/
 
 enum mcspiRegs {
@@ -128,6 +183,24 @@ enum mcspiChnRegs {
     MCSPI_CHANNEL_SIZE  = 0x14u
 };
 
+/**@brief       Shadow of module configuration registers
+ * @details     Data, status and FIFO registers are never cached. Channel
+ *              registers come first so the state used by transfers shares
+ *              one cache line with the rest of the shadow.
+ */
+struct lldShadow {
+    struct lldShadowChn {
+        uint32_t            conf;
+        uint32_t            ctrl;
+    }                   chn[SHADOW_CHN_COUNT];
+    uint32_t            sysconfig;
+    uint32_t            modulctrl;
+    uint32_t            irqenable;
+    uint32_t            xferlevel;
+    uint32_t            batch;                                                  /* Batch nesting level                                      */
+    uint32_t            dirty;                                                  /* Registers changed during a batch                         */
+} ____cacheline_aligned;
+
 /*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
 
 static inline void regWrite(
@@ -150,6 +223,31 @@ static inline uint32_t regChnRead(
     uint32_t            chn,
     enum mcspiChnRegs   reg);
 
+static inline void regChnDataWrite(
+    volatile uint8_t *  io,
+    uint32_t            chn,
+    uint32_t            val);
+
+static inline uint32_t regChnDataRead(
+    volatile uint8_t *  io,
+    uint32_t            chn);
+
+static int32_t regChnStatWait(
+    volatile uint8_t *  io,
+    uint32_t            chn,
+    uint32_t            mask);
+
+static inline uint32_t wordGet(
+    const void *        buff,
+    size_t              idx,
+    uint32_t            wordSize);
+
+static inline void wordPut(
+    void *              buff,
+    size_t              idx,
+    uint32_t            wordSize,
+    uint32_t            word);
+
 static struct devData * getDevData(
     struct rtdm_device * dev);
 
@@ -162,6 +260,30 @@ static void shadowDestroy(
 static void shadowUpdate(
     struct rtdm_device * dev);
 
+static inline struct lldShadow * shadowGet(
+    struct rtdm_device * dev);
+
+static uint32_t * shadowSlotGet(
+    struct lldShadow *  shadow,
+    enum mcspiRegs      reg,
+    uint32_t *          dirty);
+
+static uint32_t * shadowChnSlotGet(
+    struct lldShadow *  shadow,
+    uint32_t            chn,
+    enum mcspiChnRegs   reg,
+    uint32_t *          dirty);
+
+static void shadowCommit(
+    struct rtdm_device * dev);
+
+static inline void shadowStore(
+    struct rtdm_device * dev,
+    uint32_t *          slot,
+    uint32_t            dirty,
+    uint32_t            reg,
+    uint32_t            val);
+
 static inline void shadowWrite(
     struct rtdm_device * dev,
     enum mcspiRegs      reg,
@@ -171,10 +293,6 @@ static inline uint32_t shadowRead(
     struct rtdm_device * dev,
     enum mcspiRegs      reg);
 
-static inline uint32_t shadowReadUpdate(
-    struct rtdm_device * dev,
-    enum mcspiRegs      reg);
-
 static inline void shadowChnWrite(
     struct rtdm_device * dev,
     uint32_t            chn,
@@ -186,11 +304,6 @@ static inline uint32_t shadowChnRead(
     uint32_t            chn,
     enum mcspiChnRegs   reg);
 
-static inline uint32_t shadowChnReadUpdate(
-    struct rtdm_device * dev,
-    uint32_t            chn,
-    enum mcspiChnRegs   reg);
-
 /*=======================================================  LOCAL VARIABLES  ==*/
 
 DECL_MODULE_INFO("x_spi_lld", "Low-level device driver", DEF_DRV_AUTHOR);
@@ -246,6 +359,93 @@ static inline uint32_t regChnRead(
     return (ret);
 }
 
+/* NOTE: Data register accessors do not trace the access, a trace line for
+ *       every word on the bus would make the debug log unusable.
+ */
+static inline void regChnDataWrite(
+    volatile uint8_t *  io,
+    uint32_t            chn,
+    uint32_t            val) {
+
+    iowrite32(val, &io[MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + MCSPI_CH_TX]);
+}
+
+static inline uint32_t regChnDataRead(
+    volatile uint8_t *  io,
+    uint32_t            chn) {
+
+    return (ioread32(&io[MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + MCSPI_CH_RX]));
+}
+
+static int32_t regChnStatWait(
+    volatile uint8_t *  io,
+    uint32_t            chn,
+    uint32_t            mask) {
+
+    uint32_t            spin;
+
+    for (spin = 0u; spin < CFG_PIO_SPIN_LIMIT; spin++) {
+
+        if (0u != (ioread32(&io[MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + MCSPI_CH_STAT]) & mask)) {
+
+            return (0);
+        }
+    }
+    LOG_DBG("channel %d status wait timed out, mask: %x", chn, mask);
+
+    return (-ETIMEDOUT);
+}
+
+static inline uint32_t wordGet(
+    const void *        buff,
+    size_t              idx,
+    uint32_t            wordSize) {
+
+    switch (wordSize) {
+        case 1u : {
+
+            return (((const uint8_t *)buff)[idx]);
+        }
+
+        case 2u : {
+
+            return (((const uint16_t *)buff)[idx]);
+        }
+
+        default : {
+
+            return (((const uint32_t *)buff)[idx]);
+        }
+    }
+}
+
+static inline void wordPut(
+    void *              buff,
+    size_t              idx,
+    uint32_t            wordSize,
+    uint32_t            word) {
+
+    switch (wordSize) {
+        case 1u : {
+            ((uint8_t *)buff)[idx] = (uint8_t)word;
+
+            break;
+        }
+
+        case 2u : {
+            ((uint16_t *)buff)[idx] = (uint16_t)word;
+
+            break;
+        }
+
+        default : {
+            ((uint32_t *)buff)[idx] = word;
+
+            break;
+        }
+    }
+}
+
 static struct devData * getDevData(
     struct rtdm_device * dev) {
 
@@ -268,7 +468,7 @@ static int32_t shadowCreate(
     devData = getDevData(
         dev);
     devData->shadow = kmalloc(
-        devData->addr.size,
+        sizeof(struct lldShadow),
         GFP_KERNEL);
 
     if (NULL == devData->shadow) {
@@ -276,6 +476,7 @@ static int32_t shadowCreate(
 
         return (-ENOMEM);
     }
+    devData->shadow->batch = 0u;
     shadowUpdate(
         dev);
 
@@ -301,69 +502,230 @@ static void shadowDestroy(
 static void shadowUpdate(
     struct rtdm_device * dev) {
 
-    struct devData *    devData;
+    struct lldShadow *  shadow;
     volatile uint8_t *  io;
+    uint32_t            chn;
 
-    devData = getDevData(
+    shadow = shadowGet(
         dev);
     io = lldRemapGet(
         dev);
-    memcpy_fromio(
-        devData->shadow,
-        io,
-        devData->addr.size);
+    shadow->sysconfig = regRead(io, MCSPI_SYSCONFIG);
+    shadow->modulctrl = regRead(io, MCSPI_MODULCTRL);
+    shadow->irqenable = regRead(io, MCSPI_IRQENABLE);
+    shadow->xferlevel = regRead(io, MCSPI_XFERLEVEL);
+
+    for (chn = 0u; chn < SHADOW_CHN_COUNT; chn++) {
+        shadow->chn[chn].conf = regChnRead(io, chn, MCSPI_CH_CONF);
+        shadow->chn[chn].ctrl = regChnRead(io, chn, MCSPI_CH_CTRL);
+    }
+    shadow->dirty = 0u;
 }
 
-static inline void shadowWrite(
-    struct rtdm_device * dev,
+static inline struct lldShadow * shadowGet(
+    struct rtdm_device * dev) {
+
+    return (getDevData(dev)->shadow);
+}
+
+/* NOTE: Only configuration registers have a place in shadow, the rest of
+ *       module registers must be accessed directly.
+ */
+static uint32_t * shadowSlotGet(
+    struct lldShadow *  shadow,
     enum mcspiRegs      reg,
-    uint32_t            val) {
+    uint32_t *          dirty) {
+
+    switch (reg) {
+        case MCSPI_SYSCONFIG : {
+            *dirty = 0u;                                                        /* Always written through                                   */
+
+            return (&shadow->sysconfig);
+        }
+
+        case MCSPI_MODULCTRL : {
+            *dirty = SHADOW_DIRTY_MODULCTRL;
+
+            return (&shadow->modulctrl);
+        }
+
+        case MCSPI_IRQENABLE : {
+            *dirty = SHADOW_DIRTY_IRQENABLE;
+
+            return (&shadow->irqenable);
+        }
+
+        case MCSPI_XFERLEVEL : {
+            *dirty = SHADOW_DIRTY_XFERLEVEL;
+
+            return (&shadow->xferlevel);
+        }
+
+        default : {
+            ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, FALSE);
 
+            *dirty = 0u;
+
+            return (NULL);
+        }
+    }
+}
+
+static uint32_t * shadowChnSlotGet(
+    struct lldShadow *  shadow,
+    uint32_t            chn,
+    enum mcspiChnRegs   reg,
+    uint32_t *          dirty) {
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, SHADOW_CHN_COUNT > chn);
+
+    if (MCSPI_CH_CTRL == reg) {
+        *dirty = SHADOW_DIRTY_CH_CTRL(chn);
+
+        return (&shadow->chn[chn].ctrl);
+    }
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, MCSPI_CH_CONF == reg);
+
+    *dirty = SHADOW_DIRTY_CH_CONF(chn);
+
+    return (&shadow->chn[chn].conf);
+}
+
+/* NOTE: A channel must be disabled before its configuration is changed and
+ *       enabled only after the module is fully configured.
+ */
+static void shadowCommit(
+    struct rtdm_device * dev) {
+
+    struct lldShadow *  shadow;
     volatile uint8_t *  io;
-    struct devData *    devData;
+    uint32_t            dirty;
+    uint32_t            chn;
 
+    shadow = shadowGet(
+        dev);
     io = lldRemapGet(
         dev);
-    devData = getDevData(
+    dirty = shadow->dirty;
+    shadow->dirty = 0u;
+
+    for (chn = 0u; chn < SHADOW_CHN_COUNT; chn++) {
+
+        if ((0u != (dirty & SHADOW_DIRTY_CH_CTRL(chn))) &&
+            (0u == (shadow->chn[chn].ctrl & MCSPI_CH_CTRL_EN_Mask))) {
+            regChnWrite(
+                io,
+                chn,
+                MCSPI_CH_CTRL,
+                shadow->chn[chn].ctrl);
+            dirty &= ~SHADOW_DIRTY_CH_CTRL(chn);
+        }
+    }
+
+    if (0u != (dirty & SHADOW_DIRTY_MODULCTRL)) {
+        regWrite(
+            io,
+            MCSPI_MODULCTRL,
+            shadow->modulctrl);
+    }
+
+    for (chn = 0u; chn < SHADOW_CHN_COUNT; chn++) {
+
+        if (0u != (dirty & SHADOW_DIRTY_CH_CONF(chn))) {
+            regChnWrite(
+                io,
+                chn,
+                MCSPI_CH_CONF,
+                shadow->chn[chn].conf);
+        }
+    }
+
+    if (0u != (dirty & SHADOW_DIRTY_XFERLEVEL)) {
+        regWrite(
+            io,
+            MCSPI_XFERLEVEL,
+            shadow->xferlevel);
+    }
+
+    if (0u != (dirty & SHADOW_DIRTY_IRQENABLE)) {
+        regWrite(
+            io,
+            MCSPI_IRQENABLE,
+            shadow->irqenable);
+    }
+
+    for (chn = 0u; chn < SHADOW_CHN_COUNT; chn++) {
+
+        if (0u != (dirty & SHADOW_DIRTY_CH_CTRL(chn))) {
+            regChnWrite(
+                io,
+                chn,
+                MCSPI_CH_CTRL,
+                shadow->chn[chn].ctrl);
+        }
+    }
+}
+
+static inline void shadowStore(
+    struct rtdm_device * dev,
+    uint32_t *          slot,
+    uint32_t            dirty,
+    uint32_t            reg,
+    uint32_t            val) {
+
+    struct lldShadow *  shadow;
+
+    shadow = shadowGet(
         dev);
-    *((uint32_t *)&devData->shadow[reg]) = val;
+
+    if ((0u != shadow->batch) && (0u != dirty)) {
+
+        if (*slot != val) {
+            *slot = val;
+            shadow->dirty |= dirty;
+        }
+
+        return;
+    }
+    *slot = val;
     regWrite(
-        io,
+        lldRemapGet(dev),
         reg,
         val);
 }
 
-static inline uint32_t shadowRead(
+static inline void shadowWrite(
     struct rtdm_device * dev,
-    enum mcspiRegs      reg) {
-
-    uint32_t            ret;
-    struct devData *    devData;
+    enum mcspiRegs      reg,
+    uint32_t            val) {
 
-    devData = getDevData(
-        dev);
-    ret = *((uint32_t *)&devData->shadow[reg]);
-    LOG_DBG("UART rd shadow: %x : %x", reg, ret);
+    uint32_t *          slot;
+    uint32_t            dirty;
 
-    return (ret);
+    slot = shadowSlotGet(
+        shadowGet(dev),
+        reg,
+        &dirty);
+    shadowStore(
+        dev,
+        slot,
+        dirty,
+        reg,
+        val);
 }
 
-static inline uint32_t shadowReadUpdate(
+static inline uint32_t shadowRead(
     struct rtdm_device * dev,
     enum mcspiRegs      reg) {
 
     uint32_t            ret;
-    volatile uint8_t *  io;
-    struct devData *    devData;
+    uint32_t            dirty;
 
-    io = lldRemapGet(
-        dev);
-    devData = getDevData(
-        dev);
-    ret = regRead(
-        io,
-        reg);
-    *((uint32_t *)&devData->shadow[reg]) = ret;
+    ret = *shadowSlotGet(
+        shadowGet(dev),
+        reg,
+        &dirty);
+    LOG_DBG("UART rd shadow: %x : %x", reg, ret);
 
     return (ret);
 }
@@ -374,8 +736,18 @@ static inline void shadowChnWrite(
     enum mcspiChnRegs   reg,
     uint32_t            val) {
 
-    shadowWrite(
+    uint32_t *          slot;
+    uint32_t            dirty;
+
+    slot = shadowChnSlotGet(
+        shadowGet(dev),
+        chn,
+        reg,
+        &dirty);
+    shadowStore(
         dev,
+        slot,
+        dirty,
         MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + reg,
         val);
 }
@@ -386,24 +758,13 @@ static inline uint32_t shadowChnRead(
     enum mcspiChnRegs   reg) {
 
     uint32_t            ret;
+    uint32_t            dirty;
 
-    ret = shadowRead(
-        dev,
-        MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + reg);
-
-    return (ret);
-}
-
-static inline uint32_t shadowChnReadUpdate(
-    struct rtdm_device * dev,
-    uint32_t            chn,
-    enum mcspiChnRegs   reg) {
-
-    uint32_t            ret;
-
-    ret = shadowReadUpdate(
-        dev,
-        MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + reg);
+    ret = *shadowChnSlotGet(
+        shadowGet(dev),
+        chn,
+        reg,
+        &dirty);
 
     return (ret);
 }
@@ -417,6 +778,7 @@ int32_t lldDevInit(
     int32_t             ret;
     uint32_t            revision;
 
+    memset(&getDevData(dev)->stat, 0, sizeof(struct xspiStatus));
     ret = shadowCreate(
         dev);
 
@@ -424,10 +786,17 @@ int32_t lldDevInit(
 
         return (ret);
     }
-    lldReset(
+    ret = lldReset(
         dev);
-    revision = shadowRead(
-        dev,
+
+    if (0 != ret) {
+        shadowDestroy(
+            dev);
+
+        return (ret);
+    }
+    revision = regRead(
+        lldRemapGet(dev),
         MCSPI_REVISION);                                                        /* Read revision info                                       */
     LOG_INFO("hardware version: %d.%d",
         (revision & MCSPI_REVISION_X_MAJOR_Mask) >> MCSPI_REVISION_X_MAJOR_Pos,
@@ -439,7 +808,7 @@ int32_t lldDevInit(
 void lldDevTerm(
     struct rtdm_device * dev) {
 
-    lldReset(
+    (void)lldReset(
         dev);
     shadowDestroy(
         dev);
@@ -456,15 +825,51 @@ volatile uint8_t * lldRemapGet(
     return (devData->addr.remap);
 }
 
-void lldReset(
+void lldBatchBegin(
+    struct rtdm_device * dev) {
+
+    struct lldShadow *  shadow;
+
+    shadow = shadowGet(
+        dev);
+    shadow->batch++;
+}
+
+void lldBatchCommit(
+    struct rtdm_device * dev) {
+
+    struct lldShadow *  shadow;
+
+    shadow = shadowGet(
+        dev);
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, 0u != shadow->batch);
+
+    shadow->batch--;
+
+    if (0u == shadow->batch) {
+        shadowCommit(
+            dev);
+    }
+}
+
+/* NOTE: This function may be called with interrupts disabled, so the wait is
+ *       bounded. When reset does not complete the shadow is not refreshed.
+ */
+int32_t lldReset(
     struct rtdm_device * dev) {
 
     volatile uint8_t *  io;
+    struct xspiStatus * stat;
+    nanosecs_abs_t      start;
+    uint32_t            time;
     uint32_t            sysconfig;
+    uint32_t            spin;
 
     io = lldRemapGet(
         dev);
-
+    stat = &getDevData(dev)->stat;
+    start = rtdm_clock_read_monotonic();
     sysconfig = regRead(
         io,
         MCSPI_SYSCONFIG);
@@ -473,9 +878,42 @@ void lldReset(
         MCSPI_SYSCONFIG,
         sysconfig | MCSPI_SYSCONFIG_SOFTRESET_Mask);                            /* Reset device module                                      */
 
-    while (0u == (regRead(io, MCSPI_SYSSTATUS) & MCSPI_SYSSTATUS_RESETDONE_Mask));  /* Wait a few cycles for reset procedure                */
+    for (spin = 0u; spin < CFG_RESET_SPIN_LIMIT; spin++) {                      /* Wait a few cycles for reset procedure                    */
+
+        if (0u != (regRead(io, MCSPI_SYSSTATUS) & MCSPI_SYSSTATUS_RESETDONE_Mask)) {
+
+            break;
+        }
+    }
+    time = (uint32_t)(rtdm_clock_read_monotonic() - start);
+    stat->resetTimeLast = time;
+
+    if (CFG_RESET_SPIN_LIMIT == spin) {
+        stat->resetErrors++;
+        LOG_ERR("module reset timed out after %d ns", time);
+
+        return (-ETIMEDOUT);
+    }
+
+    if ((0u == stat->resets) || (time < stat->resetTimeMin)) {
+        stat->resetTimeMin = time;
+    }
+
+    if (time > stat->resetTimeMax) {
+        stat->resetTimeMax = time;
+    }
+    stat->resets++;
     shadowUpdate(
         dev);
+
+    return (0);
+}
+
+void lldStatusGet(
+    struct rtdm_device * dev,
+    struct xspiStatus * status) {
+
+    *status = getDevData(dev)->stat;
 }
 
 void lldFIFOChnEnable(
@@ -528,7 +966,7 @@ void lldCsModeSet(
         dev,
         MCSPI_MODULCTRL);
     reg &= ~MCSPI_MODULCTRL_PIN34_Mask;
-    reg |= mode & MCSPI_MODULCTRL_PIN34_Mask;
+    reg |= (mode << MCSPI_MODULCTRL_PIN34_Pos) & MCSPI_MODULCTRL_PIN34_Mask;
     shadowWrite(
         dev,
         MCSPI_MODULCTRL,
@@ -545,7 +983,7 @@ void lldModeSet(
         dev,
         MCSPI_MODULCTRL);
     reg &= ~MCSPI_MODULCTRL_MS_Mask;
-    reg |= mode & MCSPI_MODULCTRL_MS_Mask;
+    reg |= (mode << MCSPI_MODULCTRL_MS_Pos) & MCSPI_MODULCTRL_MS_Mask;
     shadowWrite(
         dev,
         MCSPI_MODULCTRL,
@@ -562,7 +1000,7 @@ void lldChannelModeSet(
         dev,
         MCSPI_MODULCTRL);
     reg &= ~MCSPI_MODULCTRL_SINGLE_Mask;
-    reg |= chnMode & MCSPI_MODULCTRL_SINGLE_Mask;
+    reg |= (chnMode << MCSPI_MODULCTRL_SINGLE_Pos) & MCSPI_MODULCTRL_SINGLE_Mask;
     shadowWrite(
         dev,
         MCSPI_MODULCTRL,
@@ -579,7 +1017,7 @@ void lldInitialDelaySet(
         dev,
         MCSPI_MODULCTRL);
     reg &= ~MCSPI_MODULCTRL_INITDLY_Mask;
-    reg |= delay & MCSPI_MODULCTRL_INITDLY_Mask;
+    reg |= (delay << MCSPI_MODULCTRL_INITDLY_Pos) & MCSPI_MODULCTRL_INITDLY_Mask;
     shadowWrite(
         dev,
         MCSPI_MODULCTRL,
@@ -598,7 +1036,31 @@ void lldChnTransferModeSet(
         chn,
         MCSPI_CH_CONF);
     reg &= ~MCSPI_CH_CONF_TRM_Mask;
-    reg |= mode & MCSPI_CH_CONF_TRM_Mask;
+    reg |= (mode << MCSPI_CH_CONF_TRM_Pos) & MCSPI_CH_CONF_TRM_Mask;
+    shadowChnWrite(
+        dev,
+        chn,
+        MCSPI_CH_CONF,
+        reg);
+}
+
+void lldChnTurboSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    bool_T              turbo) {
+
+    uint32_t            reg;
+
+    reg = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CONF);
+
+    if (TRUE == turbo) {
+        reg |= MCSPI_CH_CONF_TURBO_Mask;
+    } else {
+        reg &= ~MCSPI_CH_CONF_TURBO_Mask;
+    }
     shadowChnWrite(
         dev,
         chn,
@@ -620,7 +1082,7 @@ void lldChnPinLayoutSet(
 
     if (0 != layout) {
 /*-- Rx = SPIDAT[0], Tx = SPIDAT[1] ------------------------------------------*/
-        reg &= ~(MCSPI_CH_CONF_IS_Mask & MCSPI_CH_CONF_DPE1_Mask);
+        reg &= ~(MCSPI_CH_CONF_IS_Mask | MCSPI_CH_CONF_DPE1_Mask);
         reg |= MCSPI_CH_CONF_DPE0_Mask;
     } else {
 /*-- Rx = SPIDAT[1], Tx = SPIDAT[0] ------------------------------------------*/
@@ -646,12 +1108,136 @@ void lldChnWordLengthSet(
         chn,
         MCSPI_CH_CONF);
     reg &= ~MCSPI_CH_CONF_WL_Mask;
-    reg |= wordLength & MCSPI_CH_CONF_WL_Mask;
+    reg |= ((wordLength - 1u) << MCSPI_CH_CONF_WL_Pos) & MCSPI_CH_CONF_WL_Mask;
+    shadowChnWrite(
+        dev,
+        chn,
+        MCSPI_CH_CONF,
+        reg);
+}
+
+int32_t lldChnClkSolve(
+    uint32_t            ref,
+    uint32_t            freq,
+    struct lldChnClk *  clk) {
+
+    uint32_t            ratio;
+    uint32_t            clkd;
+
+    if (0u == freq) {
+
+        return (-EINVAL);
+    }
+    ratio = DIV_ROUND_UP(ref, freq);
+
+    if (0u == ratio) {
+        ratio = 1u;
+    }
+    clkd = 0u;
+
+    while ((1u << clkd) < ratio) {
+        clkd++;
+    }
+
+    if (MCSPI_CLK_RATIO_MAX < (1u << clkd)) {
+
+        return (-EINVAL);
+    }
+
+    if (((1u << clkd) == ratio) || (MCSPI_CLK_FINE_RATIO_MAX < ratio)) {
+        ratio     = 1u << clkd;
+        clk->conf = (clkd << MCSPI_CH_CONF_CLKD_Pos) & MCSPI_CH_CONF_CLKD_Mask;
+        clk->ctrl = 0u;
+    } else {
+        clk->conf = MCSPI_CH_CONF_CLKG_Mask |
+            (((ratio - 1u) << MCSPI_CH_CONF_CLKD_Pos) & MCSPI_CH_CONF_CLKD_Mask);
+        clk->ctrl = (((ratio - 1u) >> 4u) << MCSPI_CH_CTRL_EXTCLK_Pos) & MCSPI_CH_CTRL_EXTCLK_Mask;
+    }
+    clk->freq = ref / ratio;
+
+    return (0);
+}
+
+void lldChnClkSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const struct lldChnClk * clk) {
+
+    uint32_t            reg;
+
+    reg = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CONF);
+    reg &= ~(MCSPI_CH_CONF_CLKG_Mask | MCSPI_CH_CONF_CLKD_Mask);
+    reg |= clk->conf;
     shadowChnWrite(
         dev,
         chn,
         MCSPI_CH_CONF,
         reg);
+    reg = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CTRL);
+    reg &= ~MCSPI_CH_CTRL_EXTCLK_Mask;
+    reg |= clk->ctrl;
+    shadowChnWrite(
+        dev,
+        chn,
+        MCSPI_CH_CTRL,
+        reg);
+}
+
+void lldChnProfileGet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    struct lldChnProfile * profile) {
+
+    profile->conf = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CONF) & ~MCSPI_CH_CONF_XFER_Mask;
+    profile->ctrl = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CTRL) & MCSPI_CH_CTRL_EXTCLK_Mask;
+}
+
+void lldChnProfileSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const struct lldChnProfile * profile) {
+
+    uint32_t            old;
+    uint32_t            reg;
+
+    old = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CONF);
+    reg = (old & MCSPI_CH_CONF_XFER_Mask) | profile->conf;
+
+    if (reg != old) {
+        shadowChnWrite(
+            dev,
+            chn,
+            MCSPI_CH_CONF,
+            reg);
+    }
+    old = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CTRL);
+    reg = (old & ~MCSPI_CH_CTRL_EXTCLK_Mask) | profile->ctrl;
+
+    if (reg != old) {
+        shadowChnWrite(
+            dev,
+            chn,
+            MCSPI_CH_CTRL,
+            reg);
+    }
 }
 
 void lldChnCsDelaySet(
@@ -666,7 +1252,7 @@ void lldChnCsDelaySet(
         chn,
         MCSPI_CH_CONF);
     reg &= ~MCSPI_CH_CONF_TCS_Mask;
-    reg |= delay & MCSPI_CH_CONF_TCS_Mask;
+    reg |= (delay << MCSPI_CH_CONF_TCS_Pos) & MCSPI_CH_CONF_TCS_Mask;
     shadowChnWrite(
         dev,
         chn,
@@ -686,7 +1272,7 @@ void lldChnCsPolaritySet(
         chn,
         MCSPI_CH_CONF);
     reg &= ~MCSPI_CH_CONF_EPOL_Mask;
-    reg |= polarity & MCSPI_CH_CONF_EPOL_Mask;
+    reg |= (polarity << MCSPI_CH_CONF_EPOL_Pos) & MCSPI_CH_CONF_EPOL_Mask;
     shadowChnWrite(
         dev,
         chn,
@@ -719,7 +1305,7 @@ int32_t lldChnCsStateSet(
         chn,
         MCSPI_CH_CONF);
     reg &= ~MCSPI_CH_CONF_FORCE_Mask;
-    reg |= state & MCSPI_CH_CONF_FORCE_Mask;
+    reg |= (state << MCSPI_CH_CONF_FORCE_Pos) & MCSPI_CH_CONF_FORCE_Mask;
     shadowChnWrite(
         dev,
         chn,
@@ -729,6 +1315,388 @@ int32_t lldChnCsStateSet(
     return (0);
 }
 
+void lldChnEnable(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    uint32_t            reg;
+
+    reg = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CTRL);
+    reg |= MCSPI_CH_CTRL_EN_Mask;
+    shadowChnWrite(
+        dev,
+        chn,
+        MCSPI_CH_CTRL,
+        reg);
+}
+
+void lldChnDisable(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    uint32_t            reg;
+
+    reg = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CTRL);
+    reg &= ~MCSPI_CH_CTRL_EN_Mask;
+    shadowChnWrite(
+        dev,
+        chn,
+        MCSPI_CH_CTRL,
+        reg);
+}
+
+int32_t lldChnPioXfer(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    volatile uint8_t *  io;
+    uint32_t            trm;
+    size_t              tail;
+    size_t              cnt;
+    int32_t             ret;
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, TRUE == portChnIsOnline(dev, chn));
+
+    io = lldRemapGet(
+        dev);
+    trm = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CONF) & MCSPI_CH_CONF_TRM_Mask;
+    tail = ((2u <= words) &&
+            (0u != (shadowChnRead(dev, chn, MCSPI_CH_CONF) & MCSPI_CH_CONF_TURBO_Mask))) ?
+        2u : 1u;                                                                /* In TURBO mode the last word is already in shift register */
+    ret = 0;
+    lldChnEnable(
+        dev,
+        chn);
+
+    for (cnt = 0u; cnt < words; cnt++) {
+
+        if (MCSPI_CH_CONF_TRM_RX_ONLY != trm) {
+            ret = regChnStatWait(
+                io,
+                chn,
+                MCSPI_CH_STAT_TXS_Mask);
+
+            if (0 != ret) {
+
+                break;
+            }
+            regChnDataWrite(
+                io,
+                chn,
+                (NULL != tx) ? wordGet(tx, cnt, wordSize) : 0u);
+        }
+
+        if (MCSPI_CH_CONF_TRM_TX_ONLY != trm) {
+            uint32_t    word;
+
+            ret = regChnStatWait(
+                io,
+                chn,
+                MCSPI_CH_STAT_RXS_Mask);
+
+            if (0 != ret) {
+
+                break;
+            }
+/*-- In Rx only mode reading the last word would start yet another transfer --*/
+            if ((MCSPI_CH_CONF_TRM_RX_ONLY == trm) && ((words - tail) == cnt)) {
+                lldChnDisable(
+                    dev,
+                    chn);
+            }
+            word = regChnDataRead(
+                io,
+                chn);
+
+            if (NULL != rx) {
+                wordPut(
+                    rx,
+                    cnt,
+                    wordSize,
+                    word);
+            }
+        }
+    }
+
+    if ((0 == ret) && (MCSPI_CH_CONF_TRM_TX_ONLY == trm)) {
+        ret = regChnStatWait(
+            io,
+            chn,
+            MCSPI_CH_STAT_TXS_Mask);
+
+        if (0 == ret) {
+            ret = regChnStatWait(
+                io,
+                chn,
+                MCSPI_CH_STAT_EOT_Mask);                                        /* Wait for the last word to leave shift register           */
+        }
+    }
+    lldChnDisable(
+        dev,
+        chn);
+
+    return (ret);
+}
+
+uint32_t lldIrqStatusGet(
+    struct rtdm_device * dev) {
+
+    uint32_t            ret;
+
+    ret = regRead(
+        lldRemapGet(dev),
+        MCSPI_IRQSTATUS);
+
+    return (ret);
+}
+
+void lldIrqStatusClear(
+    struct rtdm_device * dev,
+    uint32_t            mask) {
+
+    regWrite(
+        lldRemapGet(dev),
+        MCSPI_IRQSTATUS,
+        mask);                                                                  /* Status bits are cleared by writing 1                     */
+}
+
+void lldIrqEnableSet(
+    struct rtdm_device * dev,
+    uint32_t            mask) {
+
+    shadowWrite(
+        dev,
+        MCSPI_IRQENABLE,
+        mask);
+}
+
+uint32_t lldIrqEnableGet(
+    struct rtdm_device * dev) {
+
+    uint32_t            ret;
+
+    ret = shadowRead(
+        dev,
+        MCSPI_IRQENABLE);
+
+    return (ret);
+}
+
+void lldXferLevelSet(
+    struct rtdm_device * dev,
+    uint32_t            ael,
+    uint32_t            afl,
+    uint32_t            wcnt) {
+
+    uint32_t            reg;
+
+    reg  = ((ael - 1u) << MCSPI_XFERLEVEL_AEL_Pos) & MCSPI_XFERLEVEL_AEL_Mask;
+    reg |= ((afl - 1u) << MCSPI_XFERLEVEL_AFL_Pos) & MCSPI_XFERLEVEL_AFL_Mask;
+    reg |= (wcnt << MCSPI_XFERLEVEL_WCNT_Pos) & MCSPI_XFERLEVEL_WCNT_Mask;
+    shadowWrite(
+        dev,
+        MCSPI_XFERLEVEL,
+        reg);
+}
+
+void lldChnFifoWrite(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    const void *        tx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    volatile uint8_t *  io;
+    size_t              cnt;
+
+    io = lldRemapGet(
+        dev);
+
+    if (NULL != tx) {
+
+        for (cnt = 0u; cnt < words; cnt++) {
+            regChnDataWrite(
+                io,
+                chn,
+                wordGet(tx, cnt, wordSize));
+        }
+    } else {
+
+        for (cnt = 0u; cnt < words; cnt++) {
+            regChnDataWrite(
+                io,
+                chn,
+                0u);
+        }
+    }
+}
+
+void lldChnFifoRead(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    volatile uint8_t *  io;
+    size_t              cnt;
+
+    io = lldRemapGet(
+        dev);
+
+    for (cnt = 0u; cnt < words; cnt++) {
+        uint32_t        word;
+
+        word = regChnDataRead(
+            io,
+            chn);
+
+        if (NULL != rx) {
+            wordPut(
+                rx,
+                cnt,
+                wordSize,
+                word);
+        }
+    }
+}
+
+int32_t lldChnFifoDrain(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    volatile uint8_t *  io;
+    size_t              cnt;
+    int32_t             ret;
+
+    io = lldRemapGet(
+        dev);
+    ret = 0;
+
+    for (cnt = 0u; cnt < words; cnt++) {
+        uint32_t        word;
+
+        ret = regChnStatWait(
+            io,
+            chn,
+            MCSPI_CH_STAT_RXS_Mask);
+
+        if (0 != ret) {
+
+            break;
+        }
+        word = regChnDataRead(
+            io,
+            chn);
+
+        if (NULL != rx) {
+            wordPut(
+                rx,
+                cnt,
+                wordSize,
+                word);
+        }
+    }
+
+    return (ret);
+}
+
+int32_t lldChnEotWait(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    volatile uint8_t *  io;
+    uint32_t            empty;
+    int32_t             ret;
+
+    io = lldRemapGet(
+        dev);
+    empty = (0u != (shadowChnRead(dev, chn, MCSPI_CH_CONF) & MCSPI_CH_CONF_FFEW_Mask)) ?
+        MCSPI_CH_STAT_TXFFE_Mask :
+        MCSPI_CH_STAT_TXS_Mask;
+    ret = regChnStatWait(
+        io,
+        chn,
+        empty);                                                                 /* EOT is also set between two words                        */
+
+    if (0 == ret) {
+        ret = regChnStatWait(
+            io,
+            chn,
+            MCSPI_CH_STAT_EOT_Mask);
+    }
+
+    return (ret);
+}
+
+void lldChnDmaSet(
+    struct rtdm_device * dev,
+    uint32_t            chn,
+    bool_T              tx,
+    bool_T              rx) {
+
+    uint32_t            reg;
+
+    reg = shadowChnRead(
+        dev,
+        chn,
+        MCSPI_CH_CONF);
+    reg &= ~(MCSPI_CH_CONF_DMAW_Mask | MCSPI_CH_CONF_DMAR_Mask);
+
+    if (TRUE == tx) {
+        reg |= MCSPI_CH_CONF_DMAW_Mask;
+    }
+
+    if (TRUE == rx) {
+        reg |= MCSPI_CH_CONF_DMAR_Mask;
+    }
+    shadowChnWrite(
+        dev,
+        chn,
+        MCSPI_CH_CONF,
+        reg);
+}
+
+dma_addr_t lldChnTxAddrGet(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    struct devData *    devData;
+
+    devData = getDevData(
+        dev);
+
+    return ((dma_addr_t)devData->addr.phy + MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + MCSPI_CH_TX);
+}
+
+dma_addr_t lldChnRxAddrGet(
+    struct rtdm_device * dev,
+    uint32_t            chn) {
+
+    struct devData *    devData;
+
+    devData = getDevData(
+        dev);
+
+    return ((dma_addr_t)devData->addr.phy + MCSPI_CHANNEL_BASE + (chn * MCSPI_CHANNEL_SIZE) + MCSPI_CH_RX);
+}
+
 /*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
 /** @endcond *//** @} *//******************************************************
  * END of x_spi_lld.c
@@ -0,0 +1,427 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Word packing implementation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <linux/string.h>
+#include <linux/errno.h>
+#include <rtdm/rtdm_driver.h>
+
+#include "drv/x_spi_pack.h"
+#include "drv/x_spi_pack_neon.h"
+#include "drv/x_spi_xfer.h"
+#include "drv/x_spi_cfg.h"
+#include "log/log.h"
+#include "dbg/dbg.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#if (1u == CFG_PACK_NEON) && defined(CONFIG_KERNEL_MODE_NEON)
+# define PACK_NEON                      1u
+#else
+# define PACK_NEON                      0u
+#endif
+
+#if (1u == PACK_NEON)
+# include <asm/neon.h>
+
+/**@brief       Shortest stream worth saving and restoring NEON state
+ */
+# define PACK_NEON_MIN_WORDS            64u
+#endif
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void unpackBits(
+    void *              dst,
+    const uint8_t *     src,
+    size_t              words,
+    uint32_t            wordLength);
+
+static void packBits(
+    uint8_t *           dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO("x_spi_pack", "Word packing", DEF_DRV_AUTHOR);
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+/* NOTE: Generic path for any word length, it is used for widths without a
+ *       specialised loop and for the tail of a stream.
+ */
+static void unpackBits(
+    void *              dst,
+    const uint8_t *     src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    uint64_t            acc;
+    uint32_t            bits;
+    uint32_t            mask;
+    uint32_t            wordSize;
+    size_t              i;
+
+    acc = 0u;
+    bits = 0u;
+    mask = (uint32_t)((1ull << wordLength) - 1u);
+    wordSize = xferWordSize(
+        wordLength);
+
+    for (i = 0u; i < words; i++) {
+        uint32_t        word;
+
+        while (bits < wordLength) {
+            acc = (acc << 8) | *src++;
+            bits += 8u;
+        }
+        bits -= wordLength;
+        word = (uint32_t)(acc >> bits) & mask;
+
+        if (1u == wordSize) {
+            ((uint8_t *)dst)[i] = (uint8_t)word;
+        } else if (2u == wordSize) {
+            ((uint16_t *)dst)[i] = (uint16_t)word;
+        } else {
+            ((uint32_t *)dst)[i] = word;
+        }
+    }
+}
+
+static void packBits(
+    uint8_t *           dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    uint64_t            acc;
+    uint32_t            bits;
+    uint32_t            mask;
+    uint32_t            wordSize;
+    size_t              i;
+
+    acc = 0u;
+    bits = 0u;
+    mask = (uint32_t)((1ull << wordLength) - 1u);
+    wordSize = xferWordSize(
+        wordLength);
+
+    for (i = 0u; i < words; i++) {
+        uint32_t        word;
+
+        if (1u == wordSize) {
+            word = ((const uint8_t *)src)[i];
+        } else if (2u == wordSize) {
+            word = ((const uint16_t *)src)[i];
+        } else {
+            word = ((const uint32_t *)src)[i];
+        }
+        acc = (acc << wordLength) | (word & mask);
+        bits += wordLength;
+
+        while (8u <= bits) {
+            bits -= 8u;
+            *dst++ = (uint8_t)(acc >> bits);
+        }
+    }
+
+    if (0u != bits) {
+        *dst = (uint8_t)(acc << (8u - bits));                                   /* Stream does not end on a byte boundary                   */
+    }
+}
+
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int32_t packWordsGet(
+    size_t              bytes,
+    uint32_t            wordLength,
+    size_t *            words) {
+
+    if (0u != ((bytes * 8u) % wordLength)) {
+
+        return (-EINVAL);
+    }
+    *words = (bytes * 8u) / wordLength;
+
+    return (0);
+}
+
+/* NOTE: NEON is used only in Linux context. Primary mode callers do not own
+ *       the NEON state and always run the scalar loops, which are built
+ *       without NEON.
+ */
+void packUnpack(
+    void *              dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    const uint8_t *     in;
+    size_t              done;
+
+    in = (const uint8_t *)src;
+    done = 0u;
+#if (1u == PACK_NEON)
+
+    if ((PACK_NEON_MIN_WORDS <= words) && (0 == rtdm_in_rt_context())) {
+        kernel_neon_begin();
+        done = packNeonUnpack(
+            dst,
+            in,
+            words,
+            wordLength);
+        kernel_neon_end();
+        in += (done * wordLength) / 8u;
+    }
+#endif
+
+    switch (wordLength) {
+        case 8u : {
+            memcpy(
+                &((uint8_t *)dst)[done],
+                in,
+                words - done);
+            done = words;
+
+            break;
+        }
+
+        case 12u : {
+            uint16_t *  slot;
+
+            for (slot = &((uint16_t *)dst)[done]; (done + 2u) <= words; done += 2u) {
+                slot[0] = (uint16_t)(((uint32_t)in[0] << 4) | ((uint32_t)in[1] >> 4));
+                slot[1] = (uint16_t)((((uint32_t)in[1] & 0x0fu) << 8) | in[2]);
+                slot += 2u;
+                in += 3u;
+            }
+
+            break;
+        }
+
+        case 16u : {
+            uint16_t *  slot;
+
+            for (slot = &((uint16_t *)dst)[done]; done < words; done++) {
+                *slot++ = (uint16_t)(((uint32_t)in[0] << 8) | in[1]);
+                in += 2u;
+            }
+
+            break;
+        }
+
+        case 18u : {
+            uint32_t *  slot;
+
+            for (slot = &((uint32_t *)dst)[done]; (done + 4u) <= words; done += 4u) {
+                slot[0] = (((uint32_t)in[0] << 10) | ((uint32_t)in[1] << 2) | ((uint32_t)in[2] >> 6));
+                slot[1] = ((((uint32_t)in[2] & 0x3fu) << 12) | ((uint32_t)in[3] << 4) | ((uint32_t)in[4] >> 4));
+                slot[2] = ((((uint32_t)in[4] & 0x0fu) << 14) | ((uint32_t)in[5] << 6) | ((uint32_t)in[6] >> 2));
+                slot[3] = ((((uint32_t)in[6] & 0x03u) << 16) | ((uint32_t)in[7] << 8) | in[8]);
+                slot += 4u;
+                in += 9u;
+            }
+
+            break;
+        }
+
+        case 24u : {
+            uint32_t *  slot;
+
+            for (slot = &((uint32_t *)dst)[done]; done < words; done++) {
+                *slot++ = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+                in += 3u;
+            }
+
+            break;
+        }
+
+        case 32u : {
+            uint32_t *  slot;
+
+            for (slot = &((uint32_t *)dst)[done]; done < words; done++) {
+                *slot++ = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+                in += 4u;
+            }
+
+            break;
+        }
+
+        default : {
+
+            break;
+        }
+    }
+
+    if (done < words) {
+        unpackBits(
+            &((uint8_t *)dst)[done * xferWordSize(wordLength)],
+            in,
+            words - done,
+            wordLength);
+    }
+}
+
+void packPack(
+    void *              dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    uint8_t *           out;
+    size_t              done;
+
+    out = (uint8_t *)dst;
+    done = 0u;
+#if (1u == PACK_NEON)
+
+    if ((PACK_NEON_MIN_WORDS <= words) && (0 == rtdm_in_rt_context())) {
+        kernel_neon_begin();
+        done = packNeonPack(
+            out,
+            src,
+            words,
+            wordLength);
+        kernel_neon_end();
+        out += (done * wordLength) / 8u;
+    }
+#endif
+
+    switch (wordLength) {
+        case 8u : {
+            memcpy(
+                out,
+                &((const uint8_t *)src)[done],
+                words - done);
+            done = words;
+
+            break;
+        }
+
+        case 12u : {
+            const uint16_t * slot;
+
+            for (slot = &((const uint16_t *)src)[done]; (done + 2u) <= words; done += 2u) {
+                out[0] = (uint8_t)(slot[0] >> 4);
+                out[1] = (uint8_t)((slot[0] << 4) | ((slot[1] >> 8) & 0x0fu));
+                out[2] = (uint8_t)slot[1];
+                slot += 2u;
+                out += 3u;
+            }
+
+            break;
+        }
+
+        case 16u : {
+            const uint16_t * slot;
+
+            for (slot = &((const uint16_t *)src)[done]; done < words; done++) {
+                out[0] = (uint8_t)(*slot >> 8);
+                out[1] = (uint8_t)*slot;
+                slot++;
+                out += 2u;
+            }
+
+            break;
+        }
+
+        case 18u : {
+            const uint32_t * slot;
+
+            for (slot = &((const uint32_t *)src)[done]; (done + 4u) <= words; done += 4u) {
+                out[0] = (uint8_t)(slot[0] >> 10);
+                out[1] = (uint8_t)(slot[0] >> 2);
+                out[2] = (uint8_t)((slot[0] << 6) | ((slot[1] >> 12) & 0x3fu));
+                out[3] = (uint8_t)(slot[1] >> 4);
+                out[4] = (uint8_t)((slot[1] << 4) | ((slot[2] >> 14) & 0x0fu));
+                out[5] = (uint8_t)(slot[2] >> 6);
+                out[6] = (uint8_t)((slot[2] << 2) | ((slot[3] >> 16) & 0x03u));
+                out[7] = (uint8_t)(slot[3] >> 8);
+                out[8] = (uint8_t)slot[3];
+                slot += 4u;
+                out += 9u;
+            }
+
+            break;
+        }
+
+        case 24u : {
+            const uint32_t * slot;
+
+            for (slot = &((const uint32_t *)src)[done]; done < words; done++) {
+                out[0] = (uint8_t)(*slot >> 16);
+                out[1] = (uint8_t)(*slot >> 8);
+                out[2] = (uint8_t)*slot;
+                slot++;
+                out += 3u;
+            }
+
+            break;
+        }
+
+        case 32u : {
+            const uint32_t * slot;
+
+            for (slot = &((const uint32_t *)src)[done]; done < words; done++) {
+                out[0] = (uint8_t)(*slot >> 24);
+                out[1] = (uint8_t)(*slot >> 16);
+                out[2] = (uint8_t)(*slot >> 8);
+                out[3] = (uint8_t)*slot;
+                slot++;
+                out += 4u;
+            }
+
+            break;
+        }
+
+        default : {
+
+            break;
+        }
+    }
+
+    if (done < words) {
+        packBits(
+            out,
+            &((const uint8_t *)src)[done * xferWordSize(wordLength)],
+            words - done,
+            wordLength);
+    }
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_pack.c
+ ******************************************************************************/
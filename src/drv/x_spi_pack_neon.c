@@ -0,0 +1,182 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Word packing NEON loops
+ * @details     This is the only compilation unit built with NEON enabled, so
+ *              the compiler can't use NEON registers outside of
+ *              kernel_neon_begin() and kernel_neon_end().
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stddef.h>
+#include <arm_neon.h>
+
+#include "drv/x_spi_pack_neon.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+/*=======================================================  LOCAL VARIABLES  ==*/
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+/* NOTE: Three byte lanes are de-interleaved by one load: 24 bytes give 16
+ *       words of 12 bits or 8 words of 24 bits.
+ */
+size_t packNeonUnpack(
+    void *              dst,
+    const uint8_t *     src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    size_t              done;
+
+    done = 0u;
+
+    if (12u == wordLength) {
+        uint16_t *      slot;
+
+        slot = (uint16_t *)dst;
+
+        for (; (done + 16u) <= words; done += 16u) {
+            uint8x8x3_t     in;
+            uint16x8x2_t    out;
+
+            in = vld3_u8(src);
+            out.val[0] = vorrq_u16(
+                vshll_n_u8(in.val[0], 4),
+                vmovl_u8(vshr_n_u8(in.val[1], 4)));
+            out.val[1] = vorrq_u16(
+                vshll_n_u8(vand_u8(in.val[1], vdup_n_u8(0x0fu)), 8),
+                vmovl_u8(in.val[2]));
+            vst2q_u16(
+                slot,
+                out);
+            src += 24u;
+            slot += 16u;
+        }
+    } else if (24u == wordLength) {
+        uint32_t *      slot;
+
+        slot = (uint32_t *)dst;
+
+        for (; (done + 8u) <= words; done += 8u) {
+            uint8x8x3_t     in;
+            uint16x8_t      hi;
+            uint16x8_t      lo;
+
+            in = vld3_u8(src);
+            hi = vmovl_u8(in.val[0]);
+            lo = vorrq_u16(
+                vshll_n_u8(in.val[1], 8),
+                vmovl_u8(in.val[2]));
+            vst1q_u32(
+                &slot[0],
+                vorrq_u32(
+                    vshll_n_u16(vget_low_u16(hi), 16),
+                    vmovl_u16(vget_low_u16(lo))));
+            vst1q_u32(
+                &slot[4],
+                vorrq_u32(
+                    vshll_n_u16(vget_high_u16(hi), 16),
+                    vmovl_u16(vget_high_u16(lo))));
+            src += 24u;
+            slot += 8u;
+        }
+    }
+
+    return (done);
+}
+
+size_t packNeonPack(
+    uint8_t *           dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    size_t              done;
+
+    done = 0u;
+
+    if (12u == wordLength) {
+        const uint16_t * slot;
+
+        slot = (const uint16_t *)src;
+
+        for (; (done + 16u) <= words; done += 16u) {
+            uint16x8x2_t    in;
+            uint8x8x3_t     out;
+
+            in = vld2q_u16(slot);
+            out.val[0] = vshrn_n_u16(in.val[0], 4);
+            out.val[1] = vorr_u8(
+                vshl_n_u8(vmovn_u16(in.val[0]), 4),
+                vand_u8(vshrn_n_u16(in.val[1], 8), vdup_n_u8(0x0fu)));
+            out.val[2] = vmovn_u16(in.val[1]);
+            vst3_u8(
+                dst,
+                out);
+            slot += 16u;
+            dst += 24u;
+        }
+    } else if (24u == wordLength) {
+        const uint32_t * slot;
+
+        slot = (const uint32_t *)src;
+
+        for (; (done + 8u) <= words; done += 8u) {
+            uint32x4_t      w0;
+            uint32x4_t      w1;
+            uint8x8x3_t     out;
+
+            w0 = vld1q_u32(&slot[0]);
+            w1 = vld1q_u32(&slot[4]);
+            out.val[0] = vmovn_u16(vcombine_u16(
+                vshrn_n_u32(w0, 16),
+                vshrn_n_u32(w1, 16)));
+            out.val[1] = vmovn_u16(vcombine_u16(
+                vshrn_n_u32(w0, 8),
+                vshrn_n_u32(w1, 8)));
+            out.val[2] = vmovn_u16(vcombine_u16(
+                vmovn_u32(w0),
+                vmovn_u32(w1)));
+            vst3_u8(
+                dst,
+                out);
+            slot += 8u;
+            dst += 24u;
+        }
+    }
+
+    return (done);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_pack_neon.c
+ ******************************************************************************/
@@ -0,0 +1,281 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Transfer rings implementation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+
+#include "drv/x_spi_ring.h"
+#include "drv/x_spi_xfer.h"
+#include "drv/x_spi.h"
+#include "log/log.h"
+#include "dbg/dbg.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static void ringPut(
+    struct ringCtx *    ring);
+
+static void ringVmOpen(
+    struct vm_area_struct * vma);
+
+static void ringVmClose(
+    struct vm_area_struct * vma);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO("x_spi_ring", "Transfer rings", DEF_DRV_AUTHOR);
+
+static struct vm_operations_struct RingVmOps = {
+    .open               = ringVmOpen,
+    .close              = ringVmClose
+};
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static void ringPut(
+    struct ringCtx *    ring) {
+
+    if (0 != atomic_dec_and_test(&ring->ref)) {
+        LOG_DBG("releasing rings");
+        vfree(
+            ring->ctrl);
+        kfree(
+            ring);
+    }
+}
+
+static void ringVmOpen(
+    struct vm_area_struct * vma) {
+
+    struct ringCtx *    ring;
+
+    ring = (struct ringCtx *)vma->vm_private_data;
+    atomic_inc(
+        &ring->ref);
+}
+
+static void ringVmClose(
+    struct vm_area_struct * vma) {
+
+    ringPut(
+        (struct ringCtx *)vma->vm_private_data);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int32_t ringMap(
+    struct fdCtx *      fdCtx,
+    rtdm_user_info_t *  usr,
+    struct xspiRingMap * map) {
+
+    struct ringCtx *    ring;
+    int32_t             ret;
+
+    if (0 != rtdm_in_rt_context()) {
+
+        return (-ENOSYS);
+    }
+
+    if (NULL == usr) {
+
+        return (-EPERM);
+    }
+    ring = fdCtx->ring;
+
+    if (NULL == ring) {
+        uint64_t        size;
+
+        if ((0u == map->frameSize) || (0u != (map->frameSize % 4u)) ||
+            (0u == map->frames)) {
+
+            return (-EINVAL);
+        }
+        size = PAGE_SIZE + ((uint64_t)map->frameSize * map->frames * 2u);       /* Control page followed by Tx and Rx rings                 */
+
+        if (CFG_RING_SIZE_MAX < size) {
+
+            return (-EINVAL);
+        }
+        ring = kmalloc(sizeof(struct ringCtx), GFP_KERNEL);
+
+        if (NULL == ring) {
+
+            return (-ENOMEM);
+        }
+        ring->size = PAGE_ALIGN((size_t)size);
+        ring->ctrl = vmalloc_user(ring->size);                                  /* Zeroed and suitable for mapping into user space          */
+
+        if (NULL == ring->ctrl) {
+            kfree(
+                ring);
+
+            return (-ENOMEM);
+        }
+        atomic_set(
+            &ring->ref,
+            1);
+        ring->frameSize = map->frameSize;
+        ring->frames = map->frames;
+        ring->tx = (uint8_t *)ring->ctrl + PAGE_SIZE;
+        ring->rx = ring->tx + (ring->frameSize * ring->frames);
+        ring->ctrl->frameSize = ring->frameSize;
+        ring->ctrl->frames = ring->frames;
+        ring->ctrl->txOffset = (uint32_t)(ring->tx - (uint8_t *)ring->ctrl);
+        ring->ctrl->rxOffset = (uint32_t)(ring->rx - (uint8_t *)ring->ctrl);
+        fdCtx->ring = ring;
+        LOG_DBG("rings of %d frames, %d bytes each", ring->frames, ring->frameSize);
+    } else if ((map->frameSize != ring->frameSize) || (map->frames != ring->frames)) {
+
+        return (-EBUSY);
+    }
+    atomic_inc(
+        &ring->ref);                                                            /* Reference held by the mapping                            */
+    ret = rtdm_mmap_to_user(
+        usr,
+        ring->ctrl,
+        ring->size,
+        PROT_READ | PROT_WRITE,
+        &map->addr,
+        &RingVmOps,
+        ring);
+
+    if (0 != ret) {
+        LOG_DBG("failed to map rings, err: %d", -ret);
+        ringPut(
+            ring);
+
+        return (ret);
+    }
+    map->size = (uint32_t)ring->size;
+
+    return (0);
+}
+
+void ringTerm(
+    struct fdCtx *      fdCtx) {
+
+    if (NULL != fdCtx->ring) {
+        ringPut(
+            fdCtx->ring);
+        fdCtx->ring = NULL;
+    }
+}
+
+/* NOTE: Ring geometry is taken from the driver copy, the control block is
+ *       writable by the caller. Its indexes are checked against ring size and
+ *       one call executes at most one ring of frames, so a corrupted block
+ *       can't keep the bus claimed.
+ */
+int32_t ringKick(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn) {
+
+    struct ringCtx *    ring;
+    struct xspiRingCtrl * ctrl;
+    enum xspiTransferMode mode;
+    uint32_t            txTail;
+    uint32_t            rxHead;
+    int32_t             done;
+    int32_t             ret;
+
+    ring = fdCtx->ring;
+
+    if (NULL == ring) {
+
+        return (-EINVAL);
+    }
+    ctrl = ring->ctrl;
+    mode = devCtx->chn[chn].cfg.transferMode;
+    txTail = ctrl->txTail;
+    rxHead = ctrl->rxHead;
+
+    if (((ACCESS_ONCE(ctrl->txHead) - txTail) > ring->frames) ||
+        ((rxHead - ACCESS_ONCE(ctrl->rxTail)) > ring->frames)) {
+
+        return (-EINVAL);
+    }
+    done = 0;
+    ret = 0;
+
+    while ((txTail != ACCESS_ONCE(ctrl->txHead)) && ((uint32_t)done < ring->frames)) {
+        size_t          slot;
+        uint32_t        rxTail;
+
+        rxTail = ACCESS_ONCE(ctrl->rxTail);
+
+        if ((XSPI_TRANSFER_MODE_TX_ONLY != mode) && ((rxHead - rxTail) >= ring->frames)) {
+
+            break;                                                              /* Rx ring is full or Rx tail is corrupted                  */
+        }
+        smp_rmb();
+        slot = (size_t)(txTail % ring->frames) * ring->frameSize;
+        ret = xferRun(
+            dev,
+            devCtx,
+            chn,
+            (XSPI_TRANSFER_MODE_RX_ONLY != mode) ? &ring->tx[slot] : NULL,
+            (XSPI_TRANSFER_MODE_TX_ONLY != mode) ?
+                &ring->rx[(size_t)(rxHead % ring->frames) * ring->frameSize] :
+                NULL,
+            ring->frameSize);
+
+        if (0 != ret) {
+
+            break;
+        }
+        txTail++;
+
+        if (XSPI_TRANSFER_MODE_TX_ONLY != mode) {
+            rxHead++;
+        }
+        smp_wmb();                                                              /* Frame data is visible before indexes                     */
+        ctrl->txTail = txTail;
+        ctrl->rxHead = rxHead;
+        done++;
+    }
+
+    if ((0 != ret) && (0 == done)) {
+
+        return (ret);
+    }
+
+    return (done);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_ring.c
+ ******************************************************************************/
@@ -0,0 +1,1683 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Transfer engines implementation
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include "linux/math64.h"
+
+#include "drv/x_spi_xfer.h"
+#include "drv/x_spi_lld.h"
+#include "drv/x_spi.h"
+#include "port/port.h"
+#include "log/log.h"
+#include "dbg/dbg.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+/**@brief       FIFO space of one direction, both directions are always enabled
+ */
+#define XFER_FIFO_SPACE                 (LLD_FIFO_DEPTH / 2u)
+
+/**@brief       Default DMA level, DMA requests are served by hardware and need
+ *              only a small margin
+ */
+#define XFER_DMA_LEVEL                  (XFER_FIFO_SPACE / 2u)
+
+/**@brief       Default polled FIFO level, one half is refilled while the other
+ *              half is shifted out
+ */
+#define XFER_PIO_LEVEL                  (XFER_FIFO_SPACE / 2u)
+
+/**@brief       Default slave receive level, master drives the clock so the rate
+ *              is unknown and one half is drained while the other half fills
+ */
+#define XFER_SLAVE_LEVEL                (XFER_FIFO_SPACE / 2u)
+
+/**@brief       Shortest receive only transfer in words which runs in TURBO
+ *              mode, DMA without FIFO needs at least one word besides the two
+ *              read by programmed I/O
+ */
+#define XFER_TURBO_MIN_WORDS            3u
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static enum xspiEngine engineSelect(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    const void *        rx,
+    size_t              bytes);
+
+static void statUpdate(
+    struct xspiChnStatus * stat,
+    enum xspiEngine     engine,
+    size_t              bytes,
+    nanosecs_abs_t      start,
+    nanosecs_abs_t      end,
+    int32_t             status);
+
+static void statRecord(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    enum xspiEngine     engine,
+    size_t              bytes,
+    nanosecs_abs_t      start,
+    int32_t             status);
+
+static uint32_t xferLevelGet(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    enum xspiEngine     engine,
+    size_t              words,
+    uint32_t            wordSize);
+
+static bool_T xferTurboGet(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    size_t              words);
+
+static int32_t fifoXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+static int32_t pioXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+static void slaveService(
+    struct devCtx *     devCtx,
+    uint32_t            status);
+
+static int irqHandler(
+    rtdm_irq_t *        irq);
+
+static void irqStart(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+static void irqStop(
+    struct xferCtx *    xfer);
+
+static int32_t irqXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+
+#if (0u != CFG_DMA_MODE)
+static dma_addr_t dmaAddrGet(
+    const struct xferBuff * buff,
+    const void *        ptr,
+    size_t              bytes);
+
+static int32_t dmaInit(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx);
+
+static void dmaTerm(
+    struct devCtx *     devCtx);
+
+static void dmaDone(
+    void *              arg,
+    int32_t             status);
+
+static int32_t dmaXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize);
+#endif
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+DECL_MODULE_INFO("x_spi_xfer", "Transfer engines", DEF_DRV_AUTHOR);
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+/* NOTE: Transfers shorter than pioThreshold always go through programmed I/O.
+ *       Longer transfers between driver buffers are moved by DMA when it is
+ *       available, otherwise the FIFO channel is serviced from interrupt.
+ */
+static enum xspiEngine engineSelect(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    const void *        rx,
+    size_t              bytes) {
+
+    if (bytes < devCtx->cfg.pioThreshold) {
+
+        return (XSPI_ENGINE_PIO);
+    }
+#if (0u != CFG_DMA_MODE)
+
+    if ((2u <= (bytes / xferWordSize(devCtx->chn[chn].cfg.wordLength))) &&
+        ((NULL == tx) || (0u != dmaAddrGet(&devCtx->buff, tx, bytes))) &&
+        ((NULL == rx) || (0u != dmaAddrGet(&devCtx->buff, rx, bytes)))) {
+
+        return (XSPI_ENGINE_DMA);
+    }
+#endif
+
+    if ((XSPI_FIFO_CHN_DISABLED != devCtx->cfg.fifoChn) &&
+        (chn == (uint32_t)devCtx->cfg.fifoChn) &&
+        (LLD_WCNT_MAX >= (bytes / xferWordSize(devCtx->chn[chn].cfg.wordLength)))) {
+
+        return (XSPI_ENGINE_IRQ);
+    }
+
+    return (XSPI_ENGINE_PIO);
+}
+
+/* NOTE: Device lock must be held and status sequence counter write section
+ *       entered. Channel timestamps are those of the last successful transfer.
+ */
+static void statUpdate(
+    struct xspiChnStatus * chnStat,
+    enum xspiEngine     engine,
+    size_t              bytes,
+    nanosecs_abs_t      start,
+    nanosecs_abs_t      end,
+    int32_t             status) {
+
+    struct xspiEngineStatus * stat;
+    uint32_t            time;
+
+    stat = &chnStat->engine[engine];
+
+    if (0 != status) {
+        stat->errors++;
+
+        return;
+    }
+    time = (uint32_t)(end - start);
+    chnStat->timeStart = start;
+    chnStat->timeEnd = end;
+
+    if ((0u == stat->xfers) || (time < stat->timeMin)) {
+        stat->timeMin = time;
+    }
+
+    if (time > stat->timeMax) {
+        stat->timeMax = time;
+    }
+    stat->xfers++;
+    stat->bytes += bytes;
+    stat->time += (uint64_t)time;
+    stat->timeLast = time;
+}
+
+/* NOTE: Transfer ends when this function is called.
+ */
+static void statRecord(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    enum xspiEngine     engine,
+    size_t              bytes,
+    nanosecs_abs_t      start,
+    int32_t             status) {
+
+    rtdm_lockctx_t      lockCtx;
+    nanosecs_abs_t      end;
+
+    end = rtdm_clock_read_monotonic();
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    write_seqcount_begin(
+        &devCtx->statSeq);
+    statUpdate(
+        &devCtx->chn[chn].stat,
+        engine,
+        bytes,
+        start,
+        end,
+        status);
+    write_seqcount_end(
+        &devCtx->statSeq);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+}
+
+/* NOTE: Returns FIFO level in bytes. For interrupt engine the level is the
+ *       largest multiple of word size which leaves enough FIFO space to cover
+ *       CFG_XFER_IRQ_LATENCY_NS at channel clock, so each interrupt moves as
+ *       many words as possible without underrun or overflow. When the clock is
+ *       so fast that the FIFO can't cover the latency, gaps on the bus can't be
+ *       avoided and the level falls back to half of FIFO space, which keeps
+ *       interrupts per byte low instead of raising one per word. For DMA engine
+ *       the level is the largest power-of-two burst which divides the
+ *       transfer. Polled FIFO uses half of FIFO space. Level set by
+ *       XSPI_IOC_SET_XFER_LEVEL replaces the computed limit.
+ */
+static uint32_t xferLevelGet(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    enum xspiEngine     engine,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    struct chnCgf *     chnCfg;
+    uint32_t            level;
+
+    chnCfg = &devCtx->chn[chn].cfg;
+
+    if (0u != chnCfg->xferLevel) {
+        level = chnCfg->xferLevel;
+    } else if (XSPI_ENGINE_IRQ == engine) {
+        uint64_t        bits;
+        uint64_t        margin;
+
+        bits = div_u64(                                                         /* Bits shifted while interrupt is pending                  */
+            (uint64_t)CFG_XFER_IRQ_LATENCY_NS * chnCfg->clk.freq,
+            1000000000u);
+        margin = (div_u64(bits, chnCfg->wordLength) + 1u) * wordSize;           /* 64-bit '/' would need libgcc in the module               */
+        level = (margin < XFER_FIFO_SPACE) ? (XFER_FIFO_SPACE - (uint32_t)margin) : (XFER_FIFO_SPACE / 2u);
+    } else if (XSPI_ENGINE_DMA == engine) {
+        level = XFER_DMA_LEVEL;
+    } else {
+        level = XFER_PIO_LEVEL;
+    }
+    level = min_t(uint32_t, level, (uint32_t)(words * wordSize));
+    level = max_t(uint32_t, level - (level % wordSize), wordSize);
+
+    if (XSPI_ENGINE_DMA == engine) {
+        uint32_t        burst;
+
+        burst = 1u;
+
+        while (((burst * 2u * wordSize) <= level) && (0u == (words % (burst * 2u)))) {
+            burst *= 2u;
+        }
+        level = burst * wordSize;
+    }
+
+    return (level);
+}
+
+/* NOTE: In Rx only mode TURBO lets the channel shift the next word while the
+ *       previous one waits in Rx register, so words are clocked back to back.
+ *       All engines on the FIFO channel are stopped by the word counter and
+ *       drain the FIFO at the end. Other channels are disabled two words
+ *       early.
+ */
+static bool_T xferTurboGet(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    size_t              words) {
+
+    if ((0u == CFG_XFER_TURBO) ||
+        (XSPI_TRANSFER_MODE_RX_ONLY != devCtx->chn[chn].cfg.transferMode) ||
+        (XFER_TURBO_MIN_WORDS > words)) {
+
+        return (FALSE);
+    }
+
+    return (TRUE);
+}
+
+/* NOTE: Runs the interrupt engine loop by polling. Word counter ends the
+ *       transfer in hardware while Tx FIFO is refilled and Rx FIFO drained a
+ *       whole level at a time as soon as their events are raised, so the shift
+ *       register does not wait for the previous FIFO load to be handled. Rx
+ *       tail shorter than the level is drained word by word.
+ */
+static int32_t fifoXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    struct rtdm_device * dev;
+    enum xspiTransferMode mode;
+    rtdm_lockctx_t      lockCtx;
+    size_t              txLeft;
+    size_t              rxLeft;
+    uint32_t            level;
+    uint32_t            mask;
+    uint32_t            spin;
+    int32_t             ret;
+
+    dev = devCtx->xfer.dev;
+    mode = devCtx->chn[chn].cfg.transferMode;
+    level = xferLevelGet(
+        devCtx,
+        chn,
+        XSPI_ENGINE_PIO,
+        words,
+        wordSize);
+    txLeft = (XSPI_TRANSFER_MODE_RX_ONLY == mode) ? 0u : words;
+    rxLeft = (XSPI_TRANSFER_MODE_TX_ONLY == mode) ? 0u : words;
+    mask = 0u;
+
+    if (0u != txLeft) {
+        mask |= LLD_IRQ_TX_EMPTY(chn);
+    }
+
+    if (0u != rxLeft) {
+        mask |= LLD_IRQ_RX_FULL(chn);
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnTurboSet(
+        dev,
+        chn,
+        xferTurboGet(devCtx, chn, words));
+    lldXferLevelSet(
+        dev,
+        level,
+        level,
+        (uint32_t)words);
+    lldIrqStatusClear(
+        dev,
+        ~0u);
+    lldChnEnable(
+        dev,
+        chn);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    level /= wordSize;
+    spin = 0u;
+    ret = 0;
+
+    while ((0u != txLeft) || (level <= rxLeft)) {
+        uint32_t        status;
+
+        status = lldIrqStatusGet(dev) & mask;
+
+        if (0u == status) {
+            spin++;
+
+            if (CFG_PIO_SPIN_LIMIT <= spin) {
+                LOG_DBG("FIFO transfer on channel %d timed out", chn);
+                ret = -ETIMEDOUT;
+
+                break;
+            }
+
+            continue;
+        }
+        spin = 0u;
+        lldIrqStatusClear(
+            dev,
+            status);
+
+        if (0u != (status & LLD_IRQ_TX_EMPTY(chn))) {
+            size_t      cnt;
+
+            cnt = min_t(size_t, level, txLeft);
+            lldChnFifoWrite(
+                dev,
+                chn,
+                tx,
+                cnt,
+                wordSize);
+
+            if (NULL != tx) {
+                tx = (const uint8_t *)tx + (cnt * wordSize);
+            }
+            txLeft -= cnt;
+
+            if (0u == txLeft) {
+                mask &= ~LLD_IRQ_TX_EMPTY(chn);
+            }
+        }
+
+        if (0u != (status & LLD_IRQ_RX_FULL(chn))) {
+            size_t      cnt;
+
+            cnt = min_t(size_t, level, rxLeft);
+            lldChnFifoRead(
+                dev,
+                chn,
+                rx,
+                cnt,
+                wordSize);
+
+            if (NULL != rx) {
+                rx = (uint8_t *)rx + (cnt * wordSize);
+            }
+            rxLeft -= cnt;
+        }
+    }
+
+    if (0 == ret) {
+
+        if (0u != rxLeft) {
+            ret = lldChnFifoDrain(                                              /* Tail is shorter than FIFO level                          */
+                dev,
+                chn,
+                rx,
+                rxLeft,
+                wordSize);
+        } else {
+            ret = lldChnEotWait(
+                dev,
+                chn);
+        }
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnDisable(
+        dev,
+        chn);
+    lldXferLevelSet(
+        dev,
+        1u,
+        1u,
+        0u);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (ret);
+}
+
+/* NOTE: FIFO channel transfers longer than the word counter are split, each
+ *       part keeps the FIFO busy on its own.
+ */
+static int32_t pioXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    rtdm_lockctx_t      lockCtx;
+    int32_t             ret;
+
+    if ((XSPI_FIFO_CHN_DISABLED != devCtx->cfg.fifoChn) && (chn == (uint32_t)devCtx->cfg.fifoChn)) {
+        ret = 0;
+
+        while ((0 == ret) && (0u != words)) {
+            size_t      cnt;
+
+            cnt = min_t(size_t, words, LLD_WCNT_MAX);
+            ret = fifoXfer(
+                devCtx,
+                chn,
+                tx,
+                rx,
+                cnt,
+                wordSize);
+
+            if (NULL != tx) {
+                tx = (const uint8_t *)tx + (cnt * wordSize);
+            }
+
+            if (NULL != rx) {
+                rx = (uint8_t *)rx + (cnt * wordSize);
+            }
+            words -= cnt;
+        }
+
+        return (ret);
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnTurboSet(
+        devCtx->xfer.dev,
+        chn,
+        xferTurboGet(devCtx, chn, words));
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    ret = lldChnPioXfer(
+        devCtx->xfer.dev,
+        chn,
+        tx,
+        rx,
+        words,
+        wordSize);
+
+    return (ret);
+}
+
+/* NOTE: Device lock must be held. Each Rx FIFO event moves level words into
+ *       the buffer being filled, a full buffer is passed to the reader and the
+ *       next one is filled at once. Buffers between tail and head belong to
+ *       the reader and are never written.
+ */
+static void slaveService(
+    struct devCtx *     devCtx,
+    uint32_t            status) {
+
+    struct slaveCtx *   slave;
+    struct xspiChnStatus * stat;
+
+    slave = &devCtx->slave;
+    stat = &devCtx->chn[slave->chn].stat;
+    write_seqcount_begin(
+        &devCtx->statSeq);
+
+    if (0u != (status & LLD_IRQ_RX_OVERFLOW)) {
+        stat->slaveOverflows++;
+    }
+
+    if (0u != (status & LLD_IRQ_RX_FULL(slave->chn))) {
+        size_t          left;
+
+        left = slave->level;
+
+        while (0u != left) {
+            size_t      words;
+
+            words = min_t(size_t, left, (slave->size - slave->fill) / slave->wordSize);
+            lldChnFifoRead(
+                devCtx->xfer.dev,
+                slave->chn,
+                &slave->buff[slave->head % CFG_SLAVE_BUFFS][slave->fill],
+                words,
+                slave->wordSize);
+            slave->fill += (uint32_t)(words * slave->wordSize);
+            left -= words;
+
+            if (slave->fill == slave->size) {
+                slave->fill = 0u;
+
+                if (CFG_SLAVE_BUFFS > (slave->head + 1u - slave->tail)) {
+                    slave->head++;
+                    stat->slaveBuffs++;
+                    rtdm_event_signal(
+                        &slave->ready);
+                } else {
+                    stat->slaveOverruns++;                                      /* Reader holds all other buffers, refill this one          */
+                }
+            }
+        }
+    }
+    write_seqcount_end(
+        &devCtx->statSeq);
+}
+
+/* NOTE: Status is acknowledged before FIFO is serviced. After a service the
+ *       FIFO level is below the event threshold, so an event raised while
+ *       servicing is a new one and is not lost.
+ */
+static int irqHandler(
+    rtdm_irq_t *        irq) {
+
+    struct devCtx *     devCtx;
+    struct xferCtx *    xfer;
+    void             (* complete)(struct devCtx *, int32_t);
+    uint32_t            status;
+
+    devCtx = rtdm_irq_get_arg(irq, struct devCtx);
+    xfer = &devCtx->xfer;
+    complete = NULL;
+    rtdm_lock_get(&devCtx->lock);
+    status = lldIrqStatusGet(xfer->dev) & lldIrqEnableGet(xfer->dev);
+
+    if (0u == status) {
+        rtdm_lock_put(&devCtx->lock);
+
+        return (RTDM_IRQ_NONE);
+    }
+    lldIrqStatusClear(
+        xfer->dev,
+        status);
+
+    if (TRUE == devCtx->slave.running) {
+        slaveService(
+            devCtx,
+            status);
+        rtdm_lock_put(&devCtx->lock);
+
+        return (RTDM_IRQ_HANDLED);
+    }
+
+    if (0u != (status & LLD_IRQ_TX_EMPTY(xfer->chn))) {
+        size_t          words;
+
+        words = min_t(size_t, xfer->level, xfer->txLeft);
+        lldChnFifoWrite(
+            xfer->dev,
+            xfer->chn,
+            xfer->tx,
+            words,
+            xfer->wordSize);
+
+        if (NULL != xfer->tx) {
+            xfer->tx += words * xfer->wordSize;
+        }
+        xfer->txLeft -= words;
+
+        if (0u == xfer->txLeft) {
+            lldIrqEnableSet(
+                xfer->dev,
+                lldIrqEnableGet(xfer->dev) & ~LLD_IRQ_TX_EMPTY(xfer->chn));
+        }
+    }
+
+    if (0u != (status & LLD_IRQ_RX_FULL(xfer->chn))) {
+        size_t          words;
+
+        words = min_t(size_t, xfer->level, xfer->rxLeft);
+        lldChnFifoRead(
+            xfer->dev,
+            xfer->chn,
+            xfer->rx,
+            words,
+            xfer->wordSize);
+
+        if (NULL != xfer->rx) {
+            xfer->rx += words * xfer->wordSize;
+        }
+        xfer->rxLeft -= words;
+    }
+
+    if (0u != (status & LLD_IRQ_EOW)) {
+
+        if (0u != xfer->rxLeft) {
+            xfer->status = lldChnFifoDrain(                                     /* Tail is shorter than FIFO level                          */
+                xfer->dev,
+                xfer->chn,
+                xfer->rx,
+                xfer->rxLeft,
+                xfer->wordSize);
+            xfer->rxLeft = 0u;
+        } else {
+            xfer->status = lldChnEotWait(
+                xfer->dev,
+                xfer->chn);
+        }
+        irqStop(
+            xfer);
+
+        if (NULL != xfer->complete) {
+            complete = xfer->complete;
+            xfer->complete = NULL;
+            write_seqcount_begin(
+                &devCtx->statSeq);
+            statUpdate(
+                &devCtx->chn[xfer->chn].stat,
+                XSPI_ENGINE_IRQ,
+                xfer->bytes,
+                xfer->start,
+                rtdm_clock_read_monotonic(),
+                xfer->status);
+            write_seqcount_end(
+                &devCtx->statSeq);
+        } else {
+            rtdm_event_signal(
+                &xfer->done);
+        }
+    }
+    rtdm_lock_put(&devCtx->lock);
+
+    if (NULL != complete) {
+        complete(                                                               /* May start the next transfer                              */
+            devCtx,
+            xfer->status);
+    }
+
+    return (RTDM_IRQ_HANDLED);
+}
+
+static void irqStart(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    struct xferCtx *    xfer;
+    enum xspiTransferMode mode;
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            level;
+    uint32_t            mask;
+
+    xfer = &devCtx->xfer;
+    mode = devCtx->chn[chn].cfg.transferMode;
+    level = xferLevelGet(
+        devCtx,
+        chn,
+        XSPI_ENGINE_IRQ,
+        words,
+        wordSize);
+    xfer->tx = tx;
+    xfer->rx = rx;
+    xfer->txLeft = (XSPI_TRANSFER_MODE_RX_ONLY == mode) ? 0u : words;
+    xfer->rxLeft = (XSPI_TRANSFER_MODE_TX_ONLY == mode) ? 0u : words;
+    xfer->wordSize = wordSize;
+    xfer->level = level / wordSize;
+    xfer->chn = chn;
+    xfer->status = 0;
+    mask = LLD_IRQ_EOW;
+
+    if (0u != xfer->txLeft) {
+        mask |= LLD_IRQ_TX_EMPTY(chn);
+    }
+
+    if (0u != xfer->rxLeft) {
+        mask |= LLD_IRQ_RX_FULL(chn);
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnTurboSet(
+        xfer->dev,
+        chn,
+        xferTurboGet(devCtx, chn, words));
+    lldXferLevelSet(
+        xfer->dev,
+        level,
+        level,
+        (uint32_t)words);
+    lldIrqStatusClear(
+        xfer->dev,
+        ~0u);
+    lldIrqEnableSet(
+        xfer->dev,
+        mask);
+    lldChnEnable(
+        xfer->dev,
+        chn);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+}
+
+/* NOTE: Must be called with device lock held.
+ */
+static void irqStop(
+    struct xferCtx *    xfer) {
+
+    lldIrqEnableSet(
+        xfer->dev,
+        0u);
+    lldChnDisable(
+        xfer->dev,
+        xfer->chn);
+    lldXferLevelSet(
+        xfer->dev,
+        1u,
+        1u,
+        0u);
+}
+
+static int32_t irqXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    struct xferCtx *    xfer;
+    rtdm_lockctx_t      lockCtx;
+    int32_t             ret;
+
+    xfer = &devCtx->xfer;
+    xfer->complete = NULL;
+    rtdm_event_clear(
+        &xfer->done);
+    irqStart(
+        devCtx,
+        chn,
+        tx,
+        rx,
+        words,
+        wordSize);
+    ret = rtdm_event_timedwait(
+        &xfer->done,
+        CFG_XFER_TIMEOUT_NS,
+        NULL);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (0 == ret) {
+        ret = xfer->status;
+    } else {
+        LOG_DBG("interrupt transfer on channel %d failed, err: %d", chn, -ret);
+    }
+    irqStop(
+        xfer);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (ret);
+}
+
+#if (0u != CFG_DMA_MODE)
+static dma_addr_t dmaAddrGet(
+    const struct xferBuff * buff,
+    const void *        ptr,
+    size_t              bytes) {
+
+    const uint8_t *     pos;
+
+    pos = (const uint8_t *)ptr;
+
+    if ((pos >= buff->tx) && ((pos + bytes) <= &buff->tx[CFG_XFER_BUFF_SIZE])) {
+
+        return (buff->txDma + (dma_addr_t)(pos - buff->tx));
+    }
+
+    if ((pos >= buff->rx) && ((pos + bytes) <= &buff->rx[CFG_XFER_BUFF_SIZE])) {
+
+        return (buff->rxDma + (dma_addr_t)(pos - buff->rx));
+    }
+
+    return (0u);
+}
+
+static int32_t dmaInit(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx) {
+
+    uint32_t            chn;
+    int32_t             ret;
+
+    devCtx->buff.tx = portDmaBuffAlloc(
+        dev,
+        CFG_XFER_BUFF_SIZE,
+        &devCtx->buff.txDma);
+    devCtx->buff.rx = portDmaBuffAlloc(
+        dev,
+        CFG_XFER_BUFF_SIZE,
+        &devCtx->buff.rxDma);
+
+    if ((NULL == devCtx->buff.tx) || (NULL == devCtx->buff.rx)) {
+        LOG_ERR("failed to allocate DMA buffers");
+
+        if (NULL != devCtx->buff.tx) {
+            portDmaBuffFree(
+                dev,
+                CFG_XFER_BUFF_SIZE,
+                devCtx->buff.tx,
+                devCtx->buff.txDma);
+        }
+
+        if (NULL != devCtx->buff.rx) {
+            portDmaBuffFree(
+                dev,
+                CFG_XFER_BUFF_SIZE,
+                devCtx->buff.rx,
+                devCtx->buff.rxDma);
+        }
+
+        return (-ENOMEM);
+    }
+    ret = 0;
+
+    for (chn = 0u; chn < DEF_CHN_COUNT; chn++) {
+
+        if (TRUE == devCtx->chn[chn].online) {
+            ret = portDmaChnCreate(
+                dev,
+                chn,
+                dmaDone,
+                devCtx);
+
+            if (0 != ret) {
+
+                break;
+            }
+        }
+    }
+
+    if (0 != ret) {
+
+        while (0u != chn) {
+            chn--;
+
+            if (TRUE == devCtx->chn[chn].online) {
+                portDmaChnDestroy(
+                    dev,
+                    chn);
+            }
+        }
+        portDmaBuffFree(
+            dev,
+            CFG_XFER_BUFF_SIZE,
+            devCtx->buff.tx,
+            devCtx->buff.txDma);
+        portDmaBuffFree(
+            dev,
+            CFG_XFER_BUFF_SIZE,
+            devCtx->buff.rx,
+            devCtx->buff.rxDma);
+    }
+
+    return (ret);
+}
+
+static void dmaTerm(
+    struct devCtx *     devCtx) {
+
+    struct rtdm_device * dev;
+    uint32_t            chn;
+
+    dev = devCtx->xfer.dev;
+
+    for (chn = 0u; chn < DEF_CHN_COUNT; chn++) {
+
+        if (TRUE == devCtx->chn[chn].online) {
+            portDmaChnDestroy(
+                dev,
+                chn);
+        }
+    }
+    portDmaBuffFree(
+        dev,
+        CFG_XFER_BUFF_SIZE,
+        devCtx->buff.tx,
+        devCtx->buff.txDma);
+    portDmaBuffFree(
+        dev,
+        CFG_XFER_BUFF_SIZE,
+        devCtx->buff.rx,
+        devCtx->buff.rxDma);
+}
+
+/* NOTE: Called by EDMA driver from Linux interrupt context.
+ */
+static void dmaDone(
+    void *              arg,
+    int32_t             status) {
+
+    struct devCtx *     devCtx;
+
+    devCtx = (struct devCtx *)arg;
+
+    if (0 != status) {
+        devCtx->xfer.status = status;
+    }
+    rtdm_event_signal(
+        &devCtx->xfer.done);
+}
+
+/* NOTE: Without FIFO, in Rx only mode, reading the last word from Rx register
+ *       would start yet another transfer. DMA reads all but the last word, or
+ *       the last two words in TURBO mode, and these are read by programmed
+ *       I/O after DMA requests are turned off. On the FIFO channel word
+ *       counter stops the transfer instead.
+ */
+static int32_t dmaXfer(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              words,
+    uint32_t            wordSize) {
+
+    struct xferCtx *    xfer;
+    struct portDmaXfer  dma;
+    enum xspiTransferMode mode;
+    rtdm_lockctx_t      lockCtx;
+    bool_T              fifo;
+    bool_T              turbo;
+    size_t              tail;
+    int32_t             ret;
+
+    xfer = &devCtx->xfer;
+    mode = devCtx->chn[chn].cfg.transferMode;
+    fifo = ((XSPI_FIFO_CHN_DISABLED != devCtx->cfg.fifoChn) &&
+            (chn == (uint32_t)devCtx->cfg.fifoChn)) ? TRUE : FALSE;
+    turbo = xferTurboGet(
+        devCtx,
+        chn,
+        words);
+    tail = 0u;
+
+    if ((XSPI_TRANSFER_MODE_RX_ONLY == mode) && (FALSE == fifo)) {
+        tail = (TRUE == turbo) ? 2u : 1u;
+    }
+    dma.txBuff = 0u;
+    dma.rxBuff = 0u;
+
+    if (XSPI_TRANSFER_MODE_RX_ONLY != mode) {
+
+        if (NULL == tx) {
+            memset(
+                devCtx->buff.tx,
+                0,
+                words * wordSize);
+            tx = devCtx->buff.tx;
+        }
+        dma.txBuff = dmaAddrGet(
+            &devCtx->buff,
+            tx,
+            words * wordSize);
+    }
+
+    if (XSPI_TRANSFER_MODE_TX_ONLY != mode) {
+        dma.rxBuff = dmaAddrGet(
+            &devCtx->buff,
+            (NULL != rx) ? rx : devCtx->buff.rx,                                /* Discarded words still have to be read out                */
+            words * wordSize);
+    }
+    dma.txReg = lldChnTxAddrGet(
+        xfer->dev,
+        chn);
+    dma.rxReg = lldChnRxAddrGet(
+        xfer->dev,
+        chn);
+    dma.words = words - tail;
+    dma.wordSize = wordSize;
+    dma.burst = 1u;                                                             /* Without FIFO each word is a separate request             */
+
+    if (TRUE == fifo) {
+        dma.burst = xferLevelGet(
+            devCtx,
+            chn,
+            XSPI_ENGINE_DMA,
+            dma.words,
+            wordSize) / wordSize;
+    }
+    xfer->chn = chn;
+    xfer->status = 0;
+    rtdm_event_clear(
+        &xfer->done);
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnTurboSet(
+        xfer->dev,
+        chn,
+        turbo);
+
+    if (TRUE == fifo) {
+        lldXferLevelSet(
+            xfer->dev,
+            dma.burst * wordSize,
+            dma.burst * wordSize,
+            (uint32_t)words);
+    }
+    lldChnDmaSet(
+        xfer->dev,
+        chn,
+        (0u != dma.txBuff) ? TRUE : FALSE,
+        (0u != dma.rxBuff) ? TRUE : FALSE);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    ret = portDmaChnStart(
+        xfer->dev,
+        chn,
+        &dma);
+
+    if (0 == ret) {
+        rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+        lldChnEnable(
+            xfer->dev,
+            chn);
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        ret = rtdm_event_timedwait(
+            &xfer->done,
+            CFG_XFER_TIMEOUT_NS,
+            NULL);
+
+        if (0 == ret) {
+            ret = xfer->status;
+        }
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnDmaSet(
+        xfer->dev,
+        chn,
+        FALSE,
+        FALSE);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    portDmaChnStop(
+        xfer->dev,
+        chn);
+
+    if (0 != ret) {
+        LOG_DBG("DMA transfer on channel %d failed, err: %d", chn, -ret);
+    } else if (0u != tail) {
+        ret = lldChnPioXfer(
+            xfer->dev,
+            chn,
+            NULL,
+            (NULL != rx) ? &((uint8_t *)rx)[dma.words * wordSize] : NULL,
+            tail,
+            wordSize);
+    } else if (XSPI_TRANSFER_MODE_TX_ONLY == mode) {
+        ret = lldChnEotWait(
+            xfer->dev,
+            chn);
+    }
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    lldChnDisable(
+        xfer->dev,
+        chn);
+
+    if (TRUE == fifo) {
+        lldXferLevelSet(
+            xfer->dev,
+            1u,
+            1u,
+            0u);
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (ret);
+}
+#endif
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int32_t xferInit(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx) {
+
+    struct xferCtx *    xfer;
+    int32_t             ret;
+
+    xfer = &devCtx->xfer;
+    xfer->dev = dev;
+    xfer->complete = NULL;
+    rtdm_event_init(
+        &xfer->done,
+        0ul);
+    devCtx->slave.running = FALSE;
+    rtdm_event_init(
+        &devCtx->slave.ready,
+        0ul);
+    lldIrqEnableSet(
+        dev,
+        0u);
+    ret = rtdm_irq_request(
+        &xfer->irq,
+        portIrqGet(dev),
+        irqHandler,
+        0ul,
+        dev->device_name,
+        devCtx);
+
+    if (0 != ret) {
+        LOG_ERR("failed to request interrupt %d, err: %d", portIrqGet(dev), -ret);
+        rtdm_event_destroy(
+            &devCtx->slave.ready);
+        rtdm_event_destroy(
+            &xfer->done);
+
+        return (ret);
+    }
+#if (0u != CFG_DMA_MODE)
+    ret = dmaInit(
+        dev,
+        devCtx);
+
+    if (0 != ret) {
+        rtdm_irq_free(
+            &xfer->irq);
+        rtdm_event_destroy(
+            &devCtx->slave.ready);
+        rtdm_event_destroy(
+            &xfer->done);
+    }
+#endif
+
+    return (ret);
+}
+
+void xferTerm(
+    struct devCtx *     devCtx) {
+
+    struct xferCtx *    xfer;
+
+    xfer = &devCtx->xfer;
+
+    if (TRUE == devCtx->slave.running) {
+        (void)xferSlaveStop(
+            devCtx,
+            devCtx->slave.owner,
+            devCtx->slave.chn);
+    }
+#if (0u != CFG_DMA_MODE)
+    dmaTerm(
+        devCtx);
+#endif
+    lldIrqEnableSet(
+        xfer->dev,
+        0u);
+    rtdm_irq_free(
+        &xfer->irq);
+    rtdm_event_destroy(
+        &devCtx->slave.ready);
+    rtdm_event_destroy(
+        &xfer->done);
+}
+
+uint32_t xferWordSize(
+    uint32_t            wordLength) {
+
+    if (8u >= wordLength) {
+
+        return (1u);
+    } else if (16u >= wordLength) {
+
+        return (2u);
+    } else {
+
+        return (4u);
+    }
+}
+
+int32_t xferRun(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              bytes) {
+
+    struct chnCtx *     chnCtx;
+    enum xspiEngine     engine;
+    uint32_t            wordSize;
+    nanosecs_abs_t      start;
+    int32_t             ret;
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, TRUE == devCtx->chn[chn].online);
+
+    if (TRUE == devCtx->slave.running) {                                        /* Slave receive owns the controller                        */
+
+        return (-EBUSY);
+    }
+    chnCtx = &devCtx->chn[chn];
+    wordSize = xferWordSize(
+        chnCtx->cfg.wordLength);
+
+    if (0u != (bytes % wordSize)) {
+
+        return (-EINVAL);
+    }
+    engine = engineSelect(
+        devCtx,
+        chn,
+        tx,
+        rx,
+        bytes);
+    start = rtdm_clock_read_monotonic();
+
+    switch (engine) {
+#if (0u != CFG_DMA_MODE)
+        case XSPI_ENGINE_DMA : {
+            ret = dmaXfer(
+                devCtx,
+                chn,
+                tx,
+                rx,
+                bytes / wordSize,
+                wordSize);
+
+            break;
+        }
+#endif
+
+        case XSPI_ENGINE_IRQ : {
+            ret = irqXfer(
+                devCtx,
+                chn,
+                tx,
+                rx,
+                bytes / wordSize,
+                wordSize);
+
+            break;
+        }
+
+        default : {
+            ret = pioXfer(
+                devCtx,
+                chn,
+                tx,
+                rx,
+                bytes / wordSize,
+                wordSize);
+
+            break;
+        }
+    }
+    statRecord(
+        devCtx,
+        chn,
+        engine,
+        bytes,
+        start,
+        ret);
+
+    return (ret);
+}
+
+int32_t xferPoll(
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              bytes) {
+
+    uint32_t            wordSize;
+    nanosecs_abs_t      start;
+    int32_t             ret;
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, TRUE == devCtx->chn[chn].online);
+
+    if (TRUE == devCtx->slave.running) {                                        /* Slave receive owns the controller                        */
+
+        return (-EBUSY);
+    }
+    wordSize = xferWordSize(
+        devCtx->chn[chn].cfg.wordLength);
+
+    if (0u != (bytes % wordSize)) {
+
+        return (-EINVAL);
+    }
+    start = rtdm_clock_read_monotonic();
+    ret = pioXfer(
+        devCtx,
+        chn,
+        tx,
+        rx,
+        bytes / wordSize,
+        wordSize);
+    statRecord(
+        devCtx,
+        chn,
+        XSPI_ENGINE_PIO,
+        bytes,
+        start,
+        ret);
+
+    return (ret);
+}
+
+/* NOTE: Only the FIFO channel can run without a waiting caller, its transfer
+ *       is completed by the EOW interrupt.
+ */
+int32_t xferStart(
+    struct rtdm_device * dev,
+    struct devCtx *     devCtx,
+    uint32_t            chn,
+    const void *        tx,
+    void *              rx,
+    size_t              bytes,
+    void             (* complete)(struct devCtx *, int32_t)) {
+
+    struct xferCtx *    xfer;
+    uint32_t            wordSize;
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, TRUE == devCtx->chn[chn].online);
+
+    if (TRUE == devCtx->slave.running) {                                        /* Slave receive owns the controller                        */
+
+        return (-EBUSY);
+    }
+    wordSize = xferWordSize(
+        devCtx->chn[chn].cfg.wordLength);
+
+    if ((0u == bytes) || (0u != (bytes % wordSize))) {
+
+        return (-EINVAL);
+    }
+
+    if ((XSPI_FIFO_CHN_DISABLED == devCtx->cfg.fifoChn) ||
+        (chn != (uint32_t)devCtx->cfg.fifoChn) ||
+        (LLD_WCNT_MAX < (bytes / wordSize))) {
+
+        return (-EOPNOTSUPP);
+    }
+    xfer = &devCtx->xfer;
+    xfer->complete = complete;
+    xfer->bytes = bytes;
+    xfer->start = rtdm_clock_read_monotonic();
+    irqStart(
+        devCtx,
+        chn,
+        tx,
+        rx,
+        bytes / wordSize,
+        wordSize);
+
+    return (0);
+}
+
+/* NOTE: Buffers are armed before the channel is enabled so the first word
+ *       clocked in by the master already has a place to go. Receive level
+ *       can't be derived from cfg.clk.freq, which is the master divider and
+ *       is not used in slave mode, so XFER_SLAVE_LEVEL is used unless
+ *       XSPI_IOC_SET_XFER_LEVEL sets one.
+ */
+int32_t xferSlaveStart(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn,
+    uint32_t            size) {
+
+    struct slaveCtx *   slave;
+    struct chnCtx *     chnCtx;
+    rtdm_lockctx_t      lockCtx;
+    uint32_t            wordSize;
+    uint32_t            level;
+
+    ES_DBG_API_REQUIRE(ES_DBG_USAGE_FAILURE, TRUE == devCtx->chn[chn].online);
+
+    LOG_DBG("slave start on channel %d, buffer %d bytes", chn, size);
+    chnCtx = &devCtx->chn[chn];
+    wordSize = xferWordSize(
+        chnCtx->cfg.wordLength);
+
+    if ((0u == size) || (CFG_SLAVE_BUFF_SIZE < size) || (0u != (size % wordSize))) {
+
+        return (-EINVAL);
+    }
+
+    if ((XSPI_MODE_SLAVE != devCtx->cfg.mode) ||
+        (XSPI_FIFO_CHN_DISABLED == devCtx->cfg.fifoChn) ||
+        (chn != (uint32_t)devCtx->cfg.fifoChn) ||
+        (XSPI_TRANSFER_MODE_RX_ONLY != chnCtx->cfg.transferMode)) {
+
+        return (-EOPNOTSUPP);
+    }
+    level = (0u != chnCtx->cfg.xferLevel) ? chnCtx->cfg.xferLevel : XFER_SLAVE_LEVEL;
+    level = min_t(uint32_t, level, size);
+    level = max_t(uint32_t, level - (level % wordSize), wordSize);
+    slave = &devCtx->slave;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if (TRUE == slave->running) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EBUSY);
+    }
+    slave->owner = fdCtx;
+    slave->chn = chn;
+    slave->size = size;
+    slave->wordSize = wordSize;
+    slave->level = level / wordSize;
+    slave->fill = 0u;
+    slave->head = 0u;
+    slave->tail = 0u;
+    slave->offset = 0u;
+    slave->running = TRUE;
+    chnCtx->actvCnt++;                                                          /* Channel configuration is locked while streaming          */
+    rtdm_event_clear(
+        &slave->ready);
+    lldChnTurboSet(
+        devCtx->xfer.dev,
+        chn,
+        FALSE);
+    lldXferLevelSet(
+        devCtx->xfer.dev,
+        level,
+        level,
+        0u);
+    lldIrqStatusClear(
+        devCtx->xfer.dev,
+        ~0u);
+    lldIrqEnableSet(
+        devCtx->xfer.dev,
+        LLD_IRQ_RX_FULL(chn) | LLD_IRQ_RX_OVERFLOW);
+    lldChnEnable(
+        devCtx->xfer.dev,
+        chn);
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+int32_t xferSlaveStop(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    uint32_t            chn) {
+
+    struct slaveCtx *   slave;
+    rtdm_lockctx_t      lockCtx;
+
+    LOG_DBG("slave stop on channel %d", chn);
+    slave = &devCtx->slave;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if ((FALSE == slave->running) || (chn != slave->chn)) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EINVAL);
+    }
+
+    if (fdCtx != slave->owner) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+    slave->running = FALSE;
+    lldIrqEnableSet(
+        devCtx->xfer.dev,
+        0u);
+    lldChnDisable(
+        devCtx->xfer.dev,
+        chn);
+    lldXferLevelSet(
+        devCtx->xfer.dev,
+        1u,
+        1u,
+        0u);
+    slave->tail = slave->head;                                                  /* Discard buffers not read yet                             */
+    slave->offset = 0u;
+    devCtx->chn[chn].actvCnt--;
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+    rtdm_event_signal(                                                          /* Wake up the reader                                       */
+        &slave->ready);
+
+    return (0);
+}
+
+bool_T xferSlaveIsRunning(
+    struct devCtx *     devCtx,
+    uint32_t            chn) {
+
+    return ((TRUE == devCtx->slave.running) && (chn == devCtx->slave.chn));
+}
+
+/* NOTE: Owner is checked again after each wait, streaming may have been
+ *       restarted by another descriptor meanwhile.
+ */
+int32_t xferSlavePeek(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    nanosecs_rel_t      timeout,
+    const uint8_t **    data,
+    size_t *            bytes) {
+
+    struct slaveCtx *   slave;
+    rtdm_lockctx_t      lockCtx;
+    int32_t             ret;
+
+    slave = &devCtx->slave;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    while ((fdCtx == slave->owner) && (slave->head == slave->tail) && (TRUE == slave->running)) {
+
+        if (0 > timeout) {
+            rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+            return (-EWOULDBLOCK);
+        }
+        rtdm_event_clear(
+            &slave->ready);
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+        ret = rtdm_event_timedwait(
+            &slave->ready,
+            timeout,
+            NULL);
+
+        if (0 != ret) {
+
+            return (ret);
+        }
+        rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+    }
+
+    if (fdCtx != slave->owner) {
+        rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+        return (-EACCES);
+    }
+
+    if (slave->head == slave->tail) {                                           /* Streaming stopped while waiting                          */
+        *bytes = 0u;
+    } else {
+        *data = &slave->buff[slave->tail % CFG_SLAVE_BUFFS][slave->offset];
+        *bytes = slave->size - slave->offset;
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+
+    return (0);
+}
+
+void xferSlaveConsume(
+    struct devCtx *     devCtx,
+    struct fdCtx *      fdCtx,
+    size_t              bytes) {
+
+    struct slaveCtx *   slave;
+    rtdm_lockctx_t      lockCtx;
+
+    slave = &devCtx->slave;
+    rtdm_lock_get_irqsave(&devCtx->lock, lockCtx);
+
+    if ((fdCtx == slave->owner) && (slave->head != slave->tail)) {              /* Streaming may have been stopped or restarted meantime    */
+        slave->offset += (uint32_t)bytes;
+
+        if (slave->size <= slave->offset) {
+            slave->offset = 0u;
+            slave->tail++;
+        }
+    }
+    rtdm_lock_put_irqrestore(&devCtx->lock, lockCtx);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of x_spi_xfer.c
+ ******************************************************************************/
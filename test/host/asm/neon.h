@@ -0,0 +1,6 @@
+/* Host build stand-in for kernel header, user space owns its NEON state */
+static inline void kernel_neon_begin(void) {
+}
+
+static inline void kernel_neon_end(void) {
+}
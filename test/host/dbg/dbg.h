@@ -0,0 +1,3 @@
+/* Host build stand-in for driver debug support */
+#define DECL_MODULE_INFO(modName, modDesc, modAuth)                            \
+    extern int unusedModInfo
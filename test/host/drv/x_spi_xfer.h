@@ -0,0 +1,3 @@
+/* Host build stand-in for transfer engine interface, see pack_test.c */
+uint32_t xferWordSize(
+    uint32_t            wordLength);
@@ -0,0 +1,4 @@
+/* Host build stand-in for kernel header, C library headers include the system
+ * one too, hence include_next rather than <errno.h>
+ */
+#include_next <linux/errno.h>
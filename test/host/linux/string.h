@@ -0,0 +1,2 @@
+/* Host build stand-in for kernel header */
+#include <string.h>
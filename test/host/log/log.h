@@ -0,0 +1 @@
+/* Host build stand-in for driver logging */
@@ -0,0 +1,5 @@
+/* Host build stand-in for RTDM header, tests always run in Linux context */
+static inline int rtdm_in_rt_context(void) {
+
+    return (0);
+}
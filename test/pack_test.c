@@ -0,0 +1,331 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Host test of word packing
+ * @details     Specialised scalar loops and, when built for a NEON target, the
+ *              NEON loops are compared with a bit serial reference for every
+ *              word length and for stream lengths which cover all loop tails.
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arch/compiler.h"
+#include "drv/x_spi_pack.h"
+#include "drv/x_spi_pack_neon.h"
+#include "drv/x_spi_xfer.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+/**@brief       Longest stream in words, long enough to reach NEON loops
+ */
+#define TEST_WORDS_MAX                  600u
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define TEST_NEON                      1u
+#else
+# define TEST_NEON                      0u
+#endif
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static uint32_t slotGet(
+    const void *        slots,
+    size_t              i,
+    uint32_t            wordSize);
+
+static void refUnpack(
+    void *              dst,
+    const uint8_t *     src,
+    size_t              words,
+    uint32_t            wordLength);
+
+static void refPack(
+    uint8_t *           dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength);
+
+static uint32_t check(
+    const char *        what,
+    uint32_t            wordLength,
+    size_t              words,
+    const void *        got,
+    const void *        expected,
+    size_t              bytes);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static uint8_t Stream[TEST_WORDS_MAX * 4u];
+static uint8_t Slots[TEST_WORDS_MAX * 4u];
+static uint8_t Got[TEST_WORDS_MAX * 4u];
+static uint8_t Expected[TEST_WORDS_MAX * 4u];
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static uint32_t slotGet(
+    const void *        slots,
+    size_t              i,
+    uint32_t            wordSize) {
+
+    if (1u == wordSize) {
+
+        return (((const uint8_t *)slots)[i]);
+    } else if (2u == wordSize) {
+
+        return (((const uint16_t *)slots)[i]);
+    } else {
+
+        return (((const uint32_t *)slots)[i]);
+    }
+}
+
+/* NOTE: One bit at a time, most significant bit first, shares no code with
+ *       the driver loops.
+ */
+static void refUnpack(
+    void *              dst,
+    const uint8_t *     src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    uint32_t            wordSize;
+    size_t              bit;
+    size_t              i;
+
+    wordSize = xferWordSize(
+        wordLength);
+    memset(
+        dst,
+        0,
+        words * wordSize);
+    bit = 0u;
+
+    for (i = 0u; i < words; i++) {
+        uint32_t        word;
+        uint32_t        cnt;
+
+        word = 0u;
+
+        for (cnt = 0u; cnt < wordLength; cnt++) {
+            word = (word << 1) | ((src[bit / 8u] >> (7u - (bit % 8u))) & 0x01u);
+            bit++;
+        }
+
+        if (1u == wordSize) {
+            ((uint8_t *)dst)[i] = (uint8_t)word;
+        } else if (2u == wordSize) {
+            ((uint16_t *)dst)[i] = (uint16_t)word;
+        } else {
+            ((uint32_t *)dst)[i] = word;
+        }
+    }
+}
+
+static void refPack(
+    uint8_t *           dst,
+    const void *        src,
+    size_t              words,
+    uint32_t            wordLength) {
+
+    uint32_t            wordSize;
+    size_t              bit;
+    size_t              i;
+
+    wordSize = xferWordSize(
+        wordLength);
+    memset(
+        dst,
+        0,
+        ((words * wordLength) + 7u) / 8u);
+    bit = 0u;
+
+    for (i = 0u; i < words; i++) {
+        uint32_t        word;
+        uint32_t        cnt;
+
+        word = slotGet(
+            src,
+            i,
+            wordSize);
+
+        for (cnt = wordLength; cnt != 0u; cnt--) {
+
+            if (0u != ((word >> (cnt - 1u)) & 0x01u)) {
+                dst[bit / 8u] |= (uint8_t)(0x80u >> (bit % 8u));
+            }
+            bit++;
+        }
+    }
+}
+
+static uint32_t check(
+    const char *        what,
+    uint32_t            wordLength,
+    size_t              words,
+    const void *        got,
+    const void *        expected,
+    size_t              bytes) {
+
+    if (0 != memcmp(got, expected, bytes)) {
+        printf("FAIL %s: word length %u, %u words\n", what, wordLength, (unsigned)words);
+
+        return (1u);
+    }
+
+    return (0u);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+/* NOTE: Same as the driver transfer engine, which is not built for host.
+ */
+uint32_t xferWordSize(
+    uint32_t            wordLength) {
+
+    if (8u >= wordLength) {
+
+        return (1u);
+    } else if (16u >= wordLength) {
+
+        return (2u);
+    } else {
+
+        return (4u);
+    }
+}
+
+int main(
+    void) {
+
+    uint32_t            wordLength;
+    uint32_t            cases;
+    uint32_t            fails;
+    size_t              i;
+
+    srand(1u);
+
+    for (i = 0u; i < sizeof(Stream); i++) {
+        Stream[i] = (uint8_t)rand();
+        Slots[i] = (uint8_t)rand();                                             /* Bits above word length must be ignored                   */
+    }
+    cases = 0u;
+    fails = 0u;
+
+    for (wordLength = 4u; wordLength <= 32u; wordLength++) {
+        uint32_t        wordSize;
+        size_t          words;
+
+        wordSize = xferWordSize(
+            wordLength);
+
+        for (words = 1u; words <= TEST_WORDS_MAX; words++) {
+            size_t      bytes;
+            size_t      cnt;
+
+            if (0u != ((words * wordLength) % 8u)) {
+
+                continue;                                                       /* Stream does not end on a byte boundary                   */
+            }
+
+            if ((0 != packWordsGet((words * wordLength) / 8u, wordLength, &cnt)) || (cnt != words)) {
+                printf("FAIL words: word length %u, %u words\n", wordLength, (unsigned)words);
+                fails++;
+            }
+            bytes = (words * wordLength) / 8u;
+            refUnpack(
+                Expected,
+                Stream,
+                words,
+                wordLength);
+            packUnpack(
+                Got,
+                Stream,
+                words,
+                wordLength);
+            fails += check("unpack", wordLength, words, Got, Expected, words * wordSize);
+            refPack(
+                Expected,
+                Slots,
+                words,
+                wordLength);
+            packPack(
+                Got,
+                Slots,
+                words,
+                wordLength);
+            fails += check("pack", wordLength, words, Got, Expected, bytes);
+            cases += 2u;
+#if (1u == TEST_NEON)
+
+            if ((12u == wordLength) || (24u == wordLength)) {
+                size_t  done;
+
+                refUnpack(
+                    Expected,
+                    Stream,
+                    words,
+                    wordLength);
+                memset(
+                    Got,
+                    0,
+                    words * wordSize);
+                done = packNeonUnpack(
+                    Got,
+                    Stream,
+                    words,
+                    wordLength);
+                fails += check("NEON unpack", wordLength, words, Got, Expected, done * wordSize);
+                refPack(
+                    Expected,
+                    Slots,
+                    words,
+                    wordLength);
+                done = packNeonPack(
+                    Got,
+                    Slots,
+                    words,
+                    wordLength);
+                fails += check("NEON pack", wordLength, words, Got, Expected, (done * wordLength) / 8u);
+                cases += 2u;
+            }
+#endif
+        }
+    }
+    printf("pack: %u cases, %u failed%s\n", cases, fails, (1u == TEST_NEON) ? ", NEON included" : "");
+
+    return ((0u == fails) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of pack_test.c
+ ******************************************************************************/
@@ -0,0 +1,573 @@
+/*
+ * This file is part of x_spi
+ *
+ * Copyright (C) 2011, 2012 - Nenad Radulovic
+ *
+ * x_spi is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * x_spi is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with x_spi; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA  02110-1301  USA
+ *
+ * web site:    http://blueskynet.dyndns-server.com
+ * e-mail  :    blueskyniss@gmail.com
+ *//***********************************************************************//**
+ * @file
+ * @author      Nenad Radulovic
+ * @brief       Throughput and latency benchmark
+ * @details     Drives write(), read() and XSPI_IOC_TRANSFER on one channel for
+ *              a range of transfer sizes and prints the achieved rate and the
+ *              latency of a single call. Writes are then repeated with PIO
+ *              threshold set to force programmed I/O and set to let the driver
+ *              pick EDMA, printing which engine did the work. Last, the channel
+ *              is made the FIFO channel and multi-kilobyte programmed I/O
+ *              transfers are compared with the wire rate. Calls are made from a
+ *              Xenomai task since the driver serves transfers only in real-time
+ *              context.
+ *********************************************************************//** @{ */
+
+/*=========================================================  INCLUDE FILES  ==*/
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <native/task.h>
+#include <native/timer.h>
+#include <rtdm/rtdm.h>
+
+#include "drv/x_spi_ioctl.h"
+
+/*=========================================================  LOCAL MACRO's  ==*/
+
+#define BENCH_DEF_DEVICE                "xspi.0"
+#define BENCH_DEF_RUNS                  1000u
+#define BENCH_DEF_CLOCK_FREQ            24000000
+#define BENCH_TASK_PRIO                 50
+#define BENCH_BUFF_SIZE                 8192u
+
+/*======================================================  LOCAL DATA TYPES  ==*/
+
+enum benchOp {
+    BENCH_OP_WRITE,
+    BENCH_OP_READ,
+    BENCH_OP_TRANSFER
+};
+
+struct benchResult {
+    uint64_t            time;                                                   /* Total time of all calls in ns                            */
+    uint64_t            timeMin;
+    uint64_t            timeMax;
+};
+
+/*=============================================  LOCAL FUNCTION PROTOTYPES  ==*/
+
+static int benchRun(
+    int                 fd,
+    enum benchOp        op,
+    size_t              size,
+    uint32_t            runs,
+    struct benchResult * result);
+
+static void benchPrint(
+    const char *        name,
+    size_t              size,
+    uint32_t            runs,
+    const struct benchResult * result);
+
+static int benchEngineGet(
+    int                 fd,
+    const struct xspiChnStatus * before,
+    enum xspiEngine *   engine);
+
+static int benchEngines(
+    int                 fd,
+    uint32_t            runs);
+
+static int benchFifo(
+    int                 fd,
+    int                 chn,
+    int                 clockFreq,
+    uint32_t            runs);
+
+static int benchSizes(
+    int                 fd,
+    enum benchOp        op,
+    const char *        name,
+    const size_t *      sizes,
+    size_t              count,
+    uint32_t            runs);
+
+/*=======================================================  LOCAL VARIABLES  ==*/
+
+static const char * const OpName[] = {
+    "write",
+    "read",
+    "transfer"
+};
+
+static const size_t Sizes[] = {
+    4u, 16u, 64u, 256u, 1024u, 4096u
+};
+
+static const char * const EngineName[] = {
+    "pio",
+    "irq",
+    "dma"
+};
+
+static const size_t EngineSizes[] = {
+    64u, 256u, 1024u, 4096u
+};
+
+static const size_t FifoSizes[] = {
+    2048u, 4096u, 8192u
+};
+
+static uint8_t Tx[BENCH_BUFF_SIZE];
+static uint8_t Rx[BENCH_BUFF_SIZE];
+
+/*======================================================  GLOBAL VARIABLES  ==*/
+/*============================================  LOCAL FUNCTION DEFINITIONS  ==*/
+
+static int benchRun(
+    int                 fd,
+    enum benchOp        op,
+    size_t              size,
+    uint32_t            runs,
+    struct benchResult * result) {
+
+    struct xspiTransfer transfer;
+    uint32_t            run;
+
+    transfer.tx = Tx;
+    transfer.rx = Rx;
+    transfer.length = (uint32_t)size;
+    result->time = 0u;
+    result->timeMin = UINT64_MAX;
+    result->timeMax = 0u;
+
+    for (run = 0u; run < runs; run++) {
+        RTIME           timeStart;
+        uint64_t        time;
+        ssize_t         retval;
+
+        timeStart = rt_timer_read();
+
+        switch (op) {
+            case BENCH_OP_WRITE : {
+                retval = rt_dev_write(fd, Tx, size);
+
+                break;
+            }
+
+            case BENCH_OP_READ : {
+                retval = rt_dev_read(fd, Rx, size);
+
+                break;
+            }
+
+            default : {
+                retval = rt_dev_ioctl(fd, XSPI_IOC_TRANSFER, &transfer);
+
+                if (0 == retval) {
+                    retval = (ssize_t)size;
+                }
+
+                break;
+            }
+        }
+        time = (uint64_t)(rt_timer_read() - timeStart);
+
+        if ((ssize_t)size != retval) {
+            fprintf(stderr, "%s of %zu bytes failed: %s\n", OpName[op], size, strerror((0 > retval) ? (int)-retval : EIO));
+
+            return (-1);
+        }
+        result->time += time;
+
+        if (result->timeMin > time) {
+            result->timeMin = time;
+        }
+
+        if (result->timeMax < time) {
+            result->timeMax = time;
+        }
+    }
+
+    return (0);
+}
+
+static void benchPrint(
+    const char *        name,
+    size_t              size,
+    uint32_t            runs,
+    const struct benchResult * result) {
+
+    double              rate;
+
+    rate = ((double)size * (double)runs * 1000.0) / (double)result->time;       /* Bytes per ns times 1000 gives MB/s                       */
+    printf("%-12s %6zu %10.3f %10.1f %10.1f %10.1f\n",
+        name,
+        size,
+        rate,
+        (double)result->timeMin / 1000.0,
+        ((double)result->time / (double)runs) / 1000.0,
+        (double)result->timeMax / 1000.0);
+}
+
+static int benchSizes(
+    int                 fd,
+    enum benchOp        op,
+    const char *        name,
+    const size_t *      sizes,
+    size_t              count,
+    uint32_t            runs) {
+
+    size_t              i;
+
+    for (i = 0u; i < count; i++) {
+        struct benchResult result;
+
+        if (0 != benchRun(fd, op, sizes[i], runs, &result)) {
+
+            return (-1);
+        }
+        benchPrint(
+            name,
+            sizes[i],
+            runs,
+            &result);
+    }
+
+    return (0);
+}
+
+/* NOTE: The engine which completed the most transfers since before was taken
+ *       is the one which served the case.
+ */
+static int benchEngineGet(
+    int                 fd,
+    const struct xspiChnStatus * before,
+    enum xspiEngine *   engine) {
+
+    struct xspiChnStatus after;
+    uint32_t            most;
+    uint32_t            i;
+    int                 retval;
+
+    retval = rt_dev_ioctl(fd, XSPI_IOC_GET_CHN_STATUS, &after);
+
+    if (0 != retval) {
+
+        return (retval);
+    }
+    most = 0u;
+    *engine = XSPI_ENGINE_PIO;
+
+    for (i = 0u; i < XSPI_ENGINE_COUNT; i++) {
+        uint32_t        xfers;
+
+        xfers = after.engine[i].xfers - before->engine[i].xfers;
+
+        if (most < xfers) {
+            most = xfers;
+            *engine = (enum xspiEngine)i;
+        }
+    }
+
+    return (0);
+}
+
+/* NOTE: Threshold above any transfer size keeps every transfer on programmed
+ *       I/O, zero threshold lets the driver use EDMA when it is built with
+ *       CFG_DMA_MODE, otherwise the FIFO interrupt engine or PIO runs again.
+ */
+static int benchEngines(
+    int                 fd,
+    uint32_t            runs) {
+
+    static const int    Threshold[] = {
+        INT_MAX,
+        0
+    };
+    int                 thresholdOld;
+    int                 retval;
+    size_t              i;
+
+    retval = rt_dev_ioctl(fd, XSPI_IOC_GET_PIO_THRESHOLD, &thresholdOld);
+
+    for (i = 0u; (0 == retval) && (i < (sizeof(EngineSizes) / sizeof(EngineSizes[0]))); i++) {
+        size_t          mode;
+
+        for (mode = 0u; (0 == retval) && (mode < (sizeof(Threshold) / sizeof(Threshold[0]))); mode++) {
+            struct xspiChnStatus before;
+            struct benchResult result;
+            enum xspiEngine engine;
+            char        name[16];
+
+            retval = rt_dev_ioctl(fd, XSPI_IOC_SET_PIO_THRESHOLD, Threshold[mode]);
+
+            if (0 == retval) {
+                retval = rt_dev_ioctl(fd, XSPI_IOC_GET_CHN_STATUS, &before);
+            }
+
+            if (0 == retval) {
+                retval = benchRun(fd, BENCH_OP_WRITE, EngineSizes[i], runs, &result);
+            }
+
+            if (0 == retval) {
+                retval = benchEngineGet(fd, &before, &engine);
+            }
+
+            if (0 == retval) {
+                snprintf(name, sizeof(name), "%s/%s", (0 == mode) ? "pio" : "auto", EngineName[engine]);
+                benchPrint(
+                    name,
+                    EngineSizes[i],
+                    runs,
+                    &result);
+            }
+        }
+    }
+    rt_dev_ioctl(fd, XSPI_IOC_SET_PIO_THRESHOLD, thresholdOld);
+
+    if (0 != retval) {
+        fprintf(stderr, "engine comparison stopped\n");
+    }
+
+    return (retval);
+}
+
+/* NOTE: Wire rate is SPICLK divided by 8 bits of a byte. Bus share compares
+ *       the wire rate with the time the engine spent on the bus, which leaves
+ *       out the copying between user and driver buffers.
+ */
+static int benchFifo(
+    int                 fd,
+    int                 chn,
+    int                 clockFreq,
+    uint32_t            runs) {
+
+    double              wireRate;
+    int                 fifoChnOld;
+    int                 thresholdOld;
+    int                 retval;
+    size_t              i;
+
+    wireRate = (double)clockFreq / 8.0e6;
+    retval = rt_dev_ioctl(fd, XSPI_IOC_GET_FIFO_CHN, &fifoChnOld);
+
+    if (0 == retval) {
+        retval = rt_dev_ioctl(fd, XSPI_IOC_GET_PIO_THRESHOLD, &thresholdOld);
+    }
+
+    if (0 != retval) {
+        fprintf(stderr, "FIFO channel case stopped\n");
+
+        return (retval);
+    }
+    retval = rt_dev_ioctl(fd, XSPI_IOC_SET_FIFO_CHN, chn);
+
+    if (0 == retval) {
+        retval = rt_dev_ioctl(fd, XSPI_IOC_SET_PIO_THRESHOLD, INT_MAX);
+    }
+
+    for (i = 0u; (0 == retval) && (i < (sizeof(FifoSizes) / sizeof(FifoSizes[0]))); i++) {
+        struct xspiChnStatus before;
+        struct xspiChnStatus after;
+        struct benchResult result;
+        double          rate;
+        double          busRate;
+
+        retval = rt_dev_ioctl(fd, XSPI_IOC_GET_CHN_STATUS, &before);
+
+        if (0 == retval) {
+            retval = benchRun(fd, BENCH_OP_TRANSFER, FifoSizes[i], runs, &result);
+        }
+
+        if (0 == retval) {
+            retval = rt_dev_ioctl(fd, XSPI_IOC_GET_CHN_STATUS, &after);
+        }
+
+        if (0 == retval) {
+            benchPrint(
+                "fifo/pio",
+                FifoSizes[i],
+                runs,
+                &result);
+            rate = ((double)FifoSizes[i] * (double)runs * 1000.0) / (double)result.time;
+            busRate = ((double)(after.engine[XSPI_ENGINE_PIO].bytes - before.engine[XSPI_ENGINE_PIO].bytes) * 1000.0) /
+                (double)(after.engine[XSPI_ENGINE_PIO].time - before.engine[XSPI_ENGINE_PIO].time);
+            printf("%-12s %6s %9.1f%% of wire rate, %.1f%% on the bus\n",
+                "",
+                "",
+                (rate * 100.0) / wireRate,
+                (busRate * 100.0) / wireRate);
+        }
+    }
+    rt_dev_ioctl(fd, XSPI_IOC_SET_FIFO_CHN, fifoChnOld);
+    rt_dev_ioctl(fd, XSPI_IOC_SET_PIO_THRESHOLD, thresholdOld);
+
+    if (0 != retval) {
+        fprintf(stderr, "FIFO channel case stopped\n");
+    }
+
+    return (retval);
+}
+
+/*===================================  GLOBAL PRIVATE FUNCTION DEFINITIONS  ==*/
+/*====================================  GLOBAL PUBLIC FUNCTION DEFINITIONS  ==*/
+
+int main(
+    int                 argc,
+    char **             argv) {
+
+    const char *        device;
+    RT_TASK             task;
+    uint32_t            runs;
+    int                 chn;
+    int                 clockFreq;
+    int                 opt;
+    int                 fd;
+    int                 retval;
+    size_t              i;
+
+    device = BENCH_DEF_DEVICE;
+    runs = BENCH_DEF_RUNS;
+    chn = XSPI_CHN_0;
+    clockFreq = BENCH_DEF_CLOCK_FREQ;
+
+    while (-1 != (opt = getopt(argc, argv, "d:c:f:n:"))) {
+
+        switch (opt) {
+            case 'd' : {
+                device = optarg;
+
+                break;
+            }
+
+            case 'c' : {
+                chn = atoi(optarg);
+
+                break;
+            }
+
+            case 'f' : {
+                clockFreq = atoi(optarg);
+
+                break;
+            }
+
+            case 'n' : {
+                runs = (uint32_t)strtoul(optarg, NULL, 0);
+
+                break;
+            }
+
+            default : {
+                fprintf(stderr, "usage: %s [-d device] [-c channel] [-f clock Hz] [-n runs]\n", argv[0]);
+
+                return (EXIT_FAILURE);
+            }
+        }
+    }
+
+    if (0u == runs) {
+        fprintf(stderr, "number of runs must be at least 1\n");
+
+        return (EXIT_FAILURE);
+    }
+    mlockall(MCL_CURRENT | MCL_FUTURE);
+    retval = rt_task_shadow(&task, "xspi_bench", BENCH_TASK_PRIO, 0);
+
+    if (0 != retval) {
+        fprintf(stderr, "can't become a real-time task: %s\n", strerror(-retval));
+
+        return (EXIT_FAILURE);
+    }
+    fd = rt_dev_open(device, 0);
+
+    if (0 > fd) {
+        fprintf(stderr, "can't open %s: %s\n", device, strerror(-fd));
+
+        return (EXIT_FAILURE);
+    }
+
+    for (i = 0u; i < sizeof(Tx); i++) {
+        Tx[i] = (uint8_t)i;
+    }
+    retval = rt_dev_ioctl(fd, XSPI_IOC_SET_CURRENT_CHN, chn);
+
+    if (0 == retval) {
+        retval = rt_dev_ioctl(fd, XSPI_IOC_SET_WORD_LENGTH, 8);
+    }
+
+    if (0 == retval) {
+        retval = rt_dev_ioctl(fd, XSPI_IOC_SET_CLOCK_FREQ, clockFreq);
+    }
+
+    if (0 == retval) {
+        retval = rt_dev_ioctl(fd, XSPI_IOC_GET_CLOCK_FREQ, &clockFreq);
+    }
+
+    if (0 != retval) {
+        fprintf(stderr, "can't configure channel %d: %s\n", chn, strerror(-retval));
+        rt_dev_close(fd);
+
+        return (EXIT_FAILURE);
+    }
+    printf("%s channel %d, SPICLK %d Hz, wire rate %.3f MB/s, %u runs\n",
+        device,
+        chn,
+        clockFreq,
+        (double)clockFreq / 8.0e6,
+        runs);
+    printf("%-12s %6s %10s %10s %10s %10s\n", "case", "bytes", "MB/s", "min us", "avg us", "max us");
+
+    for (i = 0u; (0 == retval) && (i < (sizeof(OpName) / sizeof(OpName[0]))); i++) {
+        retval = benchSizes(
+            fd,
+            (enum benchOp)i,
+            OpName[i],
+            Sizes,
+            sizeof(Sizes) / sizeof(Sizes[0]),
+            runs);
+    }
+
+    if (0 == retval) {
+        retval = benchEngines(
+            fd,
+            runs);
+    }
+
+    if (0 == retval) {
+        retval = benchFifo(
+            fd,
+            chn,
+            clockFreq,
+            runs);
+    }
+    rt_dev_close(fd);
+
+    return ((0 == retval) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*================================*//** @cond *//*==  CONFIGURATION ERRORS  ==*/
+/** @endcond *//** @} *//******************************************************
+ * END of xspi_bench.c
+ ******************************************************************************/